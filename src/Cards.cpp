@@ -1,11 +1,10 @@
 #include "Cards.h"
+#include "GameContext.h"
 #include "Player.h"
+#include "Random.h"
 
 #include <algorithm>
 
-// The one true deck, declared as extern in Cards.h
-Deck mainDeck = Deck();
-
 // Stream insertion operator for a card type
 std::ostream& operator << (std::ostream& out, const Card::Type& source)
 {
@@ -61,13 +60,16 @@ std::ostream& operator << (std::ostream& out, const Card& source)
     return out;
 }
 
-// Returns card back to deck
-void Card::play()
+// Returns card back to the game's deck
+void Card::play(GameContext& context)
 {
-    // Removes the card from the hand
-    hand->removeCard(*this);
+    // Removes the card from the hand, unless it was already taken out of it
+    if (hand != nullptr)
+    {
+        hand->removeCard(*this);
+    }
     // Add the card back to the deck
-    mainDeck.addCard(*this);
+    context.getDeck().addCard(*this);
 }
 
 // Returns the type of the card
@@ -99,153 +101,142 @@ void Card::setHand(Hand* hand)
 // DECK
 // Deck default constructor
 Deck::Deck():
-    cards(),
-    allCards()
+    counts(),
+    total(0),
+    cardPool(),
+    freeCards()
 {
 
 }
 
-// Deck copy constructor
-Deck::Deck(const Deck& other)
+// Deck copy constructor, copies the cards in the deck but not those in hands
+Deck::Deck(const Deck& other):
+    Deck()
 {
-    deepCopy(other);
+    *this = other;
 }
 
-// Deck destructor which deletes all cards
+// Deck destructor, the pool deletes all cards
 Deck::~Deck()
 {
-    for (const Card* card : allCards)
-    {
-        delete card;
-    }
+
 }
 
-// Assignment operator for the deck
+// Assignment operator for the deck, copies the cards in the deck but not those in hands
 void Deck::operator = (const Deck& other)
 {
-    deepCopy(other);
+    std::copy(other.counts, other.counts + static_cast<int>(Card::Type::NumTypes), counts);
+    total = other.total;
 }
 
 // Strema insertion operator for the deck
 std::ostream& operator << (std::ostream& out, const Deck& source)
 {
     out << "Deck[";
-    for (const Card* card : source.cards)
+    for (int type = 0; type < static_cast<int>(Card::Type::NumTypes); ++type)
     {
-        out << *card;
+        out << static_cast<Card::Type>(type) << "=" << source.counts[type];
+        if (type + 1 < static_cast<int>(Card::Type::NumTypes))
+        {
+            out << ",";
+        }
     }
     out << "]";
     return out;
 }
 
-// Adds a random amount of cards (with even distribution of card types)
+// Adds a number of cards (with even distribution of card types)
 void Deck::addRandomCards(int numCards)
 {
-    const static Card::Type types[] = {
-        Card::Type::Bomb,
-        Card::Type::Reinforcement,
-        Card::Type::Blockade,
-        Card::Type::Airlift,
-        Card::Type::Diplomacy
-    };
-    const static int numTypes = sizeof(types) / sizeof((types)[0]);
-
-    vector<Card*> toAdd;
-
-    // Even card type distribution
-    for (int i = 0; i < numCards; i++)
-    {
-        Card::Type type = types[i % numTypes];
-        Card* newCard = new Card(type);
-        toAdd.push_back(newCard);
-    }
-
-    // Random order
-    random_shuffle(toAdd.begin(), toAdd.end());
+    const int numTypes = static_cast<int>(Card::Type::NumTypes);
 
-    // Add to deck
-    for (Card* card : toAdd)
+    // Even card type distribution, the first types get the remainder
+    for (int type = 0; type < numTypes; ++type)
     {
-        cards.push_back(card);
+        counts[type] += numCards / numTypes + (type < numCards % numTypes ? 1 : 0);
     }
+    total += numCards;
 }
 
-// Adds a card to the deck given its reference
-// Adds the card to allCards as well if it's not already present
-// This allows us to later call a single destructor for all the cards
+// Puts a card that was drawn from this deck back into it
 void Deck::addCard(Card& card)
 {
-    cards.push_back(&card);
-    // Add all cards to the allCards if they're not there already, to destroy them all in Deck::~Deck
-    if (find(allCards.begin(), allCards.end(), &card) == allCards.end())
-    {
-        allCards.push_back(&card);
-    }
+    counts[static_cast<int>(card.getType())]++;
+    total++;
+    freeCards.push_back(&card);
 }
 
 // Removes and returns a card at random from the deck
 // Returns NULL if trying to draw a card when the deck is empty
-Card* Deck::draw()
+Card* Deck::draw(Random& random)
 {
-    size_t deckSize = cards.size();
-    if (deckSize == 0)
+    if (total == 0)
         return nullptr;
 
-    int cardIndex = rand() % deckSize;
-    // Save the card so that you can return it
-    Card* drawnCard = cards[cardIndex];
-    // Remove the card from the deck
-    cards.erase(cards.begin() + cardIndex);
+    Card::Type type = pickType(random);
+    counts[static_cast<int>(type)]--;
+    total--;
+
+    // Reuse a card of the pool, only making a new one the first time that many cards are in hands
+    if (freeCards.empty())
+    {
+        cardPool.emplace_back();
+        freeCards.push_back(&cardPool.back());
+    }
+
+    Card* drawnCard = freeCards.back();
+    freeCards.pop_back();
+    *drawnCard = Card(type);
 
     return drawnCard;
 }
 
-// Returns a reference to the deck's cards
-vector<Card*>& Deck::getCards()
+// Returns the number of cards of a type in the deck
+int Deck::count(Card::Type type) const
 {
-    return cards;
+    return counts[static_cast<int>(type)];
 }
 
-// Const version
-const vector<Card*>& Deck::getCards() const
+// Returns the number of cards in the deck
+int Deck::size() const
 {
-    return cards;
+    return total;
 }
 
-// Replaces deck with a deepy copy of the deck provided
-void Deck::deepCopy(const Deck& other)
+// Picks the type of the next card to draw
+Card::Type Deck::pickType(Random& random)
 {
-    // We'll be replacing the deck so delete all the references to the cards
-    releaseAllocs();
-
-    for (const Card* card : other.allCards)
+    // Every card of the deck is equally likely, so a type is as likely as the number of its cards
+    int cardIndex = random.nextInt(total);
+    int type = 0;
+    while (cardIndex >= counts[type])
     {
-        Card* copiedCard = new Card(*card);
-        // We copy all instances of this card to allCards for future cleanup
-        allCards.push_back(copiedCard);
-        // We copy all the cards actually currently in the deck (as opposed to allCards which includes cards in hands) into the current deck
-        if (find(other.cards.begin(), other.cards.end(), card) != other.cards.end())
-        {
-            cards.push_back(copiedCard);
-        }
+        cardIndex -= counts[type];
+        type++;
     }
+    return static_cast<Card::Type>(type);
 }
 
+// Empties the deck and takes back every card drawn from it
 void Deck::releaseAllocs()
 {
-    for (const Card* card : allCards)
+    std::fill(counts, counts + static_cast<int>(Card::Type::NumTypes), 0);
+    total = 0;
+
+    freeCards.clear();
+    for (Card& card : cardPool)
     {
-        delete card;
+        card.setHand(nullptr);
+        freeCards.push_back(&card);
     }
-
-    allCards.clear();
-    cards.clear();
 }
 
 // Hand
 // Default constructor
 Hand::Hand():
     cards(),
+    count(0),
+    typeCounts(),
     player(nullptr)
 {
 
@@ -254,6 +245,8 @@ Hand::Hand():
 // Constructor which associates a Player with a Hand
 Hand::Hand(Player& player):
     cards(),
+    count(0),
+    typeCounts(),
     player(&player)
 {
 
@@ -261,13 +254,12 @@ Hand::Hand(Player& player):
 
 // Copy constructor
 Hand::Hand(const Hand& other):
-    cards(other.cards),
-    player(other.player)
+    Hand()
 {
-
+    *this = other;
 }
 
-// Unused hand destructor because the cards in the hands are already all referenced in deck.allCards
+// Unused hand destructor because the cards in the hands belong to the deck
 Hand::~Hand()
 {
 
@@ -276,7 +268,9 @@ Hand::~Hand()
 // Assignment operator for a hand
 void Hand::operator = (const Hand& other)
 {
-    cards = other.cards;
+    std::copy(other.cards, other.cards + maxCards, cards);
+    count = other.count;
+    std::copy(other.typeCounts, other.typeCounts + static_cast<int>(Card::Type::NumTypes), typeCounts);
     player = other.player;
 }
 
@@ -284,7 +278,7 @@ void Hand::operator = (const Hand& other)
 std::ostream& operator << (std::ostream& out, const Hand& source)
 {
     out << "Hand[";
-    for (const Card* card : source.cards)
+    for (const Card* card : source)
     {
         out << *card;
     }
@@ -295,55 +289,96 @@ std::ostream& operator << (std::ostream& out, const Hand& source)
 // Adds a card to the hand and sets the Hand of the card to this
 void Hand::addCard(Card& card)
 {
-    cards.push_back(&card);
+    assert(count < maxCards);
+    if (count == maxCards)
+    {
+        return;
+    }
+
+    cards[count++] = &card;
+    typeCounts[static_cast<int>(card.getType())]++;
     card.setHand(this);
 }
 
-// Removes a card in the hand given the card's index in the hand vector
+// Removes a card in the hand given the card's index in the hand
 void Hand::removeCard(int cardIndex)
 {
-    unsigned int index = cardIndex;
-    if (index >= cards.size())
+    if (cardIndex < 0 || cardIndex >= count)
     {
         return;
     }
     // This card is now not attached to any hand, so set its hand property to nullptr
-    cards[index]->setHand(nullptr);
-    cards.erase(cards.begin() + index);
+    cards[cardIndex]->setHand(nullptr);
+    typeCounts[static_cast<int>(cards[cardIndex]->getType())]--;
+
+    // Keep the other cards in order
+    std::copy(cards + cardIndex + 1, cards + count, cards + cardIndex);
+    count--;
 }
 
 // Removes a card in the hand given a card's reference
 void Hand::removeCard(Card& card)
 {
-    auto cardToErase = std::find(cards.begin(), cards.end(), &card);
-    if (cardToErase == cards.end())
-    {
-        return;
-    }
-    // This card is now not attached to any hand, so set its hand property to nullptr
-    (*cardToErase)->setHand(nullptr);
-    cards.erase(cardToErase);
+    Card** cardToErase = std::find(cards, cards + count, &card);
+    removeCard(static_cast<int>(cardToErase - cards));
 }
 
 // Gets a card from the hand given the card's index
 Card* Hand::getCard(int cardIndex)
 {
-    unsigned int index = cardIndex;
-    if (index >= cards.size())
+    if (cardIndex < 0 || cardIndex >= count)
     {
         return nullptr;
     }
-    return cards[index];
+    return cards[cardIndex];
 }
 
-// Returns a reference to the cards in the hand
-vector<Card*>& Hand::getCards()
+// Returns the number of cards in the hand
+int Hand::size() const
 {
-    return cards;
+    return count;
+}
+
+// Checks if the hand holds maxCards cards
+bool Hand::isFull() const
+{
+    return count == maxCards;
+}
+
+// Checks if the hand has a card of a type
+bool Hand::has(Card::Type type) const
+{
+    return typeCounts[static_cast<int>(type)] > 0;
 }
 
-// Const version
-const vector<Card*>& Hand::getCards() const
+// Removes a card of a type from the hand and returns it
+Card* Hand::take(Card::Type type)
+{
+    if (!has(type))
+    {
+        return nullptr;
+    }
+
+    // The hand holds at most maxCards cards
+    for (int i = 0; i < count; ++i)
+    {
+        Card* card = cards[i];
+        if (card->getType() == type)
+        {
+            removeCard(i);
+            return card;
+        }
+    }
+    return nullptr;
+}
+
+// Iterators over the cards
+Card* const* Hand::begin() const
 {
     return cards;
 }
+
+Card* const* Hand::end() const
+{
+    return cards + count;
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include <assert.h>
+#include <deque>
 #include <ostream>
 #include <stdlib.h>
 #include <vector>
@@ -7,7 +8,9 @@
 using std::vector;
 
 // Forward declarations
+class GameContext;
 class Hand;
+class Random;
 class Player;
 class Order;
 
@@ -23,7 +26,8 @@ public:
         Reinforcement,
         Blockade,
         Airlift,
-        Diplomacy
+        Diplomacy,
+        NumTypes
     };
 
     // Stream insertion operator for Type
@@ -41,8 +45,8 @@ public:
     void operator = (const Card& other);
     // Stream insertion operator
     friend std::ostream& operator << (std::ostream& out, const Card& source);
-    // Adds the card back to deck
-    void play();
+    // Adds the card back to the game's deck
+    void play(GameContext& context);
     // Returns the type of the card
     Type getType() const;
     // Returns the hand which the card is part of
@@ -58,7 +62,9 @@ private:
     Hand* hand;
 };
 
-// Deck class which is setup once and from then on, the Player's can draw a finite collection of cards from it into their hand
+// Deck class which is setup once and from then on, the Player's can draw a finite collection of cards from it into their hand.
+// The deck only counts how many cards of each type it holds, so drawing, returning and refilling don't depend on its size.
+// Cards drawn into hands come from a pool that keeps its cards from one game to the next, so they aren't allocated every time.
 class Deck
 {
 public:
@@ -73,49 +79,56 @@ public:
     void operator = (const Deck& other);
     // Stream insertion operator
     friend std::ostream& operator << (std::ostream& out, const Deck& source);
-    // Adds a random amount of cards (with even distribution of card types)
+    // Adds a number of cards (with even distribution of card types). Cards are drawn at random, so they don't need shuffling.
     void addRandomCards(int numCards);
-    // Adds a card to the deck given its reference (adds the card to mainDeck.allCards as well if it's not already present)
+    // Puts a card that was drawn from this deck back into it (ex: when the card is played)
     void addCard(Card& card);
     // Removes and returns a card at random from the deck (returns NULL if trying to draw a card when the deck is empty)
-    Card* draw();
-    // Returns a reference to the deck's cards
-    vector<Card*>& getCards();
-    // Const version
-    const vector<Card*>& getCards() const;
-    // Clears all the cards owned by this deck
+    Card* draw(Random& random);
+    // Returns the number of cards of a type in the deck
+    int count(Card::Type type) const;
+    // Returns the number of cards in the deck
+    int size() const;
+    // Empties the deck and takes back every card drawn from it, keeping them for the next game
     void releaseAllocs();
 
 private:
 
-    // Replaces deck with a deepy copy of the deck provided
-    void deepCopy(const Deck& other);
-
-    // The cards currently present in the deck
-    vector<Card*> cards;
-    // All the cards that were ever instantiated, be they in the deck or in a player's hand
-    // It's here to facilitat ethe job of cleaning up
-    vector<Card*> allCards;
+    // Picks the type of the next card to draw (the deck must not be empty)
+    Card::Type pickType(Random& random);
+
+    // Number of cards of each type in the deck
+    int counts[static_cast<int>(Card::Type::NumTypes)];
+    // Total number of cards in the deck
+    int total;
+    // Every card that was drawn from this deck, in hands or not. A deque doesn't move them when it grows.
+    std::deque<Card> cardPool;
+    // Cards of the pool that aren't in a hand
+    vector<Card*> freeCards;
 };
 
-// Each player has a hand which may or may not contain some cards which allow them to issue special orders
+// Each player has a hand which may or may not contain some cards which allow them to issue special orders.
+// Hands hold at most maxCards cards, stored in place along with how many cards of each type they hold.
 class Hand
 {
 public:
 
+    // Maximum number of cards in a hand
+    static const int maxCards = 6;
+
     // Constructor which associates a Player with a Hand
     Hand(Player& player);
     // Copy constructor
     Hand(const Hand& other);
-    // Unused hand destructor because the cards in the hands are already all referenced in deck.allCards
+    // Unused hand destructor because the cards in the hands belong to the deck
     ~Hand();
     // Assignment operator
     void operator = (const Hand& other);
     // Stream insertion operator
     friend std::ostream& operator << (std::ostream& out, const Hand& source);
-    // Adds a card to the hand and sets the Hand of the card to this
+    // Adds a card to the hand and sets the Hand of the card to this (the hand must not be full)
     void addCard(Card& card);
-    // Removes a card in the hand given the card's index in the hand vector
+    // Removes a card in the hand given the card's index in the hand
     void removeCard(int index);
     // Removes a card in the hand given a card's reference
     void removeCard(Card& card);
@@ -123,21 +136,28 @@ public:
     Card* getCard(int index);
     // Returns the Player who's hand has this card
     Player* getPlayer() const;
-    // Returns a reference to the cards in the hand
-    vector<Card*>& getCards();
-    // Const version
-    const vector<Card*>& getCards() const;
+    // Returns the number of cards in the hand
+    int size() const;
+    // Checks if the hand holds maxCards cards
+    bool isFull() const;
+    // Checks if the hand has a card of a type
+    bool has(Card::Type type) const;
+    // Removes a card of a type from the hand and returns it, ready to be played (nullptr if there is none)
+    Card* take(Card::Type type);
+    // Iterators over the cards, for range-based for loops (removing cards invalidates them)
+    Card* const* begin() const;
+    Card* const* end() const;
 
 private:
 
     // Default constructor isn't allowed. A hand must always be attached to a Player
     Hand();
-    // The cards present in the hand
-    vector<Card*> cards;
+    // The cards present in the hand, in the order they were added
+    Card* cards[maxCards];
+    // Number of cards in the hand
+    int count;
+    // Number of cards of each type in the hand
+    int typeCounts[static_cast<int>(Card::Type::NumTypes)];
     // The player which has this hand
     Player* player;
 };
-
-// Seeing as there's a single deck, we define the deck as extern and use it everywhere else.
-// This way, we don't have to mess around with copying over decks or using getters.
-extern Deck mainDeck;
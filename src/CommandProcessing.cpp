@@ -11,7 +11,11 @@ TournamentCommandData::TournamentCommandData():
     maps(),
     strategies(),
     games(0),
-    maxTurns(0)
+    maxTurns(0),
+    threads(1),
+    seed(0),
+    hasSeed(false),
+    turnsPlayed(0)
 {
 
 }
@@ -20,7 +24,11 @@ TournamentCommandData::TournamentCommandData(TournamentCommandData& other):
     maps(other.maps),
     strategies(other.strategies),
     games(other.games),
-    maxTurns(other.maxTurns)
+    maxTurns(other.maxTurns),
+    threads(other.threads),
+    seed(other.seed),
+    hasSeed(other.hasSeed),
+    turnsPlayed(other.turnsPlayed)
 {
 
 }
@@ -31,6 +39,10 @@ TournamentCommandData& TournamentCommandData::operator = (const TournamentComman
     this->strategies = other.strategies;
     this->games = other.games;
     this->maxTurns = other.maxTurns;
+    this->threads = other.threads;
+    this->seed = other.seed;
+    this->hasSeed = other.hasSeed;
+    this->turnsPlayed = other.turnsPlayed;
     return *this;
 }
 
@@ -46,7 +58,11 @@ std::ostream& operator << (std::ostream& out, const TournamentCommandData& sourc
     {
         out << strategy << " ";
     }
-    out << "-G " << source.games << " -D " << source.maxTurns;
+    out << "-G " << source.games << " -D " << source.maxTurns << " -T " << source.threads;
+    if (source.hasSeed)
+    {
+        out << " -S " << source.seed;
+    }
     return out;
 }
 
@@ -101,6 +117,29 @@ bool TournamentCommandData::parseStream(std::istream& in)
 
     in >> maxTurns;
 
+    // Optional flags
+    while (in >> word)
+    {
+        if (word == "-T")
+        {
+            in >> threads;
+        }
+        else if (word == "-S")
+        {
+            in >> seed;
+            hasSeed = true;
+        }
+        else
+        {
+            return false;
+        }
+
+        if (in.fail())
+        {
+            return false;
+        }
+    }
+
     return true;
 }
 
@@ -206,22 +245,27 @@ const std::string& Command::getArgument() const
 void Command::saveEffect(const std::string& description)
 {
     effect = description;
-    // Notify the observers that the Command object has changed
-    notify();
+    // Publish that the command was executed
+    EventBus::publish(CommandEvent{ *this, false });
 }
 
 void Command::saveEffect(const char* description)
 {
     effect = description;
-    // Notify the observers that the Command object has changed
-    notify();
+    // Publish that the command was executed
+    EventBus::publish(CommandEvent{ *this, false });
 }
 
-string Command::stringToLog()
+
+/* --- CommandEvent --- */
+
+std::ostream& CommandEvent::print(std::ostream& out) const
 {
-    std::ostringstream stream;
-    stream << "Command executed: " << *this;
-    return stream.str();
+    if (saved)
+    {
+        return out << "CommandProcessor saved command: " << command;
+    }
+    return out << "Command executed: " << command;
 }
 
 
@@ -278,11 +322,6 @@ Command* CommandProcessor::getCommand()
     if (command != nullptr)
     {
         saveCommand(*command);
-
-        for (Observer* observer : observers)
-        {
-            command->attach(*observer);
-        }
     }
     return command;
 }
@@ -395,7 +434,7 @@ Command* CommandProcessor::readCommand()
         }
         else
         {
-            std::cout << "Invalid arguments. Format is: tournament -M <listofmapfiles> -P <listofplayerstrategies> -G <numberofgames> -D <maxnumberofturns>" << std::endl;
+            std::cout << "Invalid arguments. Format is: tournament -M <listofmapfiles> -P <listofplayerstrategies> -G <numberofgames> -D <maxnumberofturns> [-T <numberofthreads>] [-S <seed>]" << std::endl;
             delete data;
             return new Command(Command::Type::Invalid, line);
         }
@@ -423,17 +462,8 @@ Command* CommandProcessor::readCommand()
 void CommandProcessor::saveCommand(Command& command)
 {
     commands.push_back(&command);
-    // Notify the observers that the CommandProcessor object has changed
-    notify();
-}
-
-string CommandProcessor::stringToLog()
-{
-    Command* lastCommand = commands.back();
-
-    std::ostringstream stream;
-    stream << "CommandProcessor saved command: " << *lastCommand;
-    return stream.str();
+    // Publish that the command was saved
+    EventBus::publish(CommandEvent{ command, true });
 }
 
 
@@ -1,7 +1,8 @@
 #pragma once
-#include "LoggingObserver.h"
+#include "EventBus.h"
 #include "GameEngine.h"
 
+#include <cstdint>
 #include <fstream>
 #include <string>
 #include <vector>
@@ -31,10 +32,18 @@ public:
     int games;
     // Amount of turns to execute before declaring a game draw
     int maxTurns;
+    // Amount of worker threads playing games concurrently (optional, defaults to 1)
+    int threads;
+    // Seed of the tournament's random number generators (optional, picked at random if not provided)
+    std::uint64_t seed;
+    // Whether a seed was provided or picked
+    bool hasSeed;
+    // Total number of turns played by the tournament's games (set once the tournament is played)
+    std::uint64_t turnsPlayed;
 };
 
 // Represents a command (may include a string parameter)
-class Command : public Subject, public ILoggable
+class Command
 {
 public:
 
@@ -82,9 +91,6 @@ public:
     //void saveEffect(std::string description);
     void saveEffect(const char* description);
 
-    // Implementation of stringToLog function inherited from ILoggable
-    string stringToLog();
-
     void* data;
 
 private:
@@ -98,8 +104,20 @@ private:
     std::string effect;
 };
 
+// Event published when a command is saved by a CommandProcessor, or when its effect is saved after execution
+struct CommandEvent
+{
+    // The command
+    const Command& command;
+    // Whether it was saved by a CommandProcessor rather than executed
+    bool saved;
+
+    // Prints the event as it is logged
+    std::ostream& print(std::ostream& out) const;
+};
+
 // Reads command from console input
-class CommandProcessor : public Subject, public ILoggable
+class CommandProcessor
 {
 public:
 
@@ -124,9 +142,6 @@ public:
     // Checks if the command is valid given the game engine's current state
     bool validate(Command& command);
 
-    // Implementation of stringToLog function inherited from ILoggable
-    string stringToLog();
-
 protected:
 
     // Prompts the user to input a well-formed command
@@ -0,0 +1,94 @@
+#pragma once
+#include <algorithm>
+#include <vector>
+
+// Central bus that game objects publish their events to, with one list of subscribers per type of event.
+// Event types are plain structs, known at compile time: publishing calls each subscriber's update method for
+// that type directly, and costs a single check when the type has no subscribers.
+// Subscribing and unsubscribing must not happen while other threads publish (ex: during a tournament).
+// Headless builds (compiled with WARZONE_HEADLESS, ex: Warzone_Sim) have no events at all: publishing compiles away.
+namespace EventBus
+{
+#ifdef WARZONE_HEADLESS
+    const bool enabled = false;
+#else
+    const bool enabled = true;
+#endif
+
+    // Subscribers of one type of event
+    template <typename Event>
+    struct Channel
+    {
+        // Calls the update method of a subscriber
+        typedef void (*Callback)(void* subscriber, const Event& event);
+
+        // A subscriber, and how to call it
+        struct Subscription
+        {
+            void* subscriber;
+            Callback callback;
+        };
+
+        static std::vector<Subscription> subscriptions;
+    };
+
+    template <typename Event>
+    std::vector<typename Channel<Event>::Subscription> Channel<Event>::subscriptions;
+
+    // Makes publishing an event call subscriber.update(event), unless the subscriber already is subscribed to it
+    template <typename Event, typename Subscriber>
+    void subscribe(Subscriber& subscriber)
+    {
+        if (!enabled)
+        {
+            return;
+        }
+
+        std::vector<typename Channel<Event>::Subscription>& subscriptions = Channel<Event>::subscriptions;
+        for (const typename Channel<Event>::Subscription& subscription : subscriptions)
+        {
+            if (subscription.subscriber == &subscriber)
+            {
+                return;
+            }
+        }
+
+        typename Channel<Event>::Callback callback = [](void* target, const Event& event)
+        {
+            static_cast<Subscriber*>(target)->update(event);
+        };
+        subscriptions.push_back({ &subscriber, callback });
+    }
+
+    // Stops calling a subscriber for a type of event
+    template <typename Event>
+    void unsubscribe(const void* subscriber)
+    {
+        std::vector<typename Channel<Event>::Subscription>& subscriptions = Channel<Event>::subscriptions;
+        subscriptions.erase(std::remove_if(subscriptions.begin(), subscriptions.end(),
+            [&](const typename Channel<Event>::Subscription& subscription) { return subscription.subscriber == subscriber; }),
+            subscriptions.end());
+    }
+
+    // Checks if a type of event has subscribers, so that publishers can skip preparing events nobody receives
+    template <typename Event>
+    inline bool hasSubscribers()
+    {
+        return enabled && !Channel<Event>::subscriptions.empty();
+    }
+
+    // Calls the update method of every subscriber of the event's type, in the order they subscribed
+    template <typename Event>
+    inline void publish(const Event& event)
+    {
+        if (!enabled)
+        {
+            return;
+        }
+
+        for (const typename Channel<Event>::Subscription& subscription : Channel<Event>::subscriptions)
+        {
+            subscription.callback(subscription.subscriber, event);
+        }
+    }
+}
@@ -0,0 +1,822 @@
+#include "EventLog.h"
+#include "CommandProcessing.h"
+#include "GameContext.h"
+#include "GameEngine.h"
+#include "Map.h"
+#include "Orders.h"
+#include "Player.h"
+
+#include <algorithm>
+#include <sstream>
+
+/* --- EventLogObserver --- */
+
+// Game played on the current thread, as last seen by an event log
+struct EventLogThreadState
+{
+    const EventLogObserver* log;
+    std::uint32_t game;
+    std::uint16_t turn;
+    // Players of the game, by player number - 1
+    std::vector<const Player*> players;
+    // Record and text being written, kept to reuse its memory
+    std::string bytes;
+};
+
+static thread_local EventLogThreadState threadState;
+
+// Returns the state of the current thread for an event log, starting over when the thread used another one
+static EventLogThreadState& getThreadState(const EventLogObserver* log)
+{
+    if (threadState.log != log)
+    {
+        threadState.log = log;
+        threadState.game = 0;
+        threadState.turn = 0;
+        threadState.players.clear();
+    }
+    return threadState;
+}
+
+// Returns an empty record of the game played on the current thread
+static EventRecord makeRecord(const EventLogThreadState& state, EventKind kind)
+{
+    EventRecord record = {};
+    record.game = state.game;
+    record.turn = state.turn;
+    record.kind = kind;
+    return record;
+}
+
+const char EventLogObserver::header[8] = { 'W', 'Z', 'E', 'V', 'L', 'O', 'G', '1' };
+
+EventLogObserver::EventLogObserver():
+    EventLogObserver("gamelog.wzlog")
+{
+
+}
+
+EventLogObserver::EventLogObserver(const std::string& filepath):
+    LogObserver(filepath, ios_base::out | ios_base::binary),
+    namesMutex(),
+    mapNames(),
+    reasons()
+{
+    std::string bytes(header, sizeof(header));
+    enqueue(bytes);
+}
+
+EventLogObserver::EventLogObserver(const EventLogObserver& other):
+    EventLogObserver()
+{
+
+}
+
+EventLogObserver::~EventLogObserver()
+{
+    unsubscribe();
+}
+
+EventLogObserver& EventLogObserver::operator = (const EventLogObserver& other)
+{
+    return *this;
+}
+
+std::ostream& operator << (std::ostream& out, const EventLogObserver& source)
+{
+    out << "EventLogObserver maps: " << source.mapNames.size();
+    return out;
+}
+
+void EventLogObserver::subscribe()
+{
+    EventBus::subscribe<CommandEvent>(*this);
+    EventBus::subscribe<EngineEvent>(*this);
+    EventBus::subscribe<OrderEvent>(*this);
+}
+
+void EventLogObserver::unsubscribe()
+{
+    EventBus::unsubscribe<CommandEvent>(this);
+    EventBus::unsubscribe<EngineEvent>(this);
+    EventBus::unsubscribe<OrderEvent>(this);
+}
+
+void EventLogObserver::update(const CommandEvent& event)
+{
+    // Commands have no record of their own
+    std::ostringstream stream;
+    event.print(stream);
+    writeText(stream.str());
+}
+
+void EventLogObserver::writeText(const std::string& line)
+{
+    EventRecord record = makeRecord(getThreadState(this), EventKind::Text);
+    record.values[0] = static_cast<std::int32_t>(line.size());
+    write(record, line.data(), line.size());
+}
+
+void EventLogObserver::update(const EngineEvent& event)
+{
+    GameEngine& engine = event.engine;
+    const Player* player = event.player;
+    EventLogThreadState& state = getThreadState(this);
+    GameContext& context = engine.getContext();
+    state.game = context.getGameIndex();
+    state.turn = static_cast<std::uint16_t>(context.getGameTurn());
+
+    switch (event.event)
+    {
+        case GameEngine::Event::StateChanged:
+        {
+            // Every game starts by loading its map
+            if (engine.getState() == GameEngine::State::MapLoaded)
+            {
+                state.players.clear();
+
+                EventRecord started = makeRecord(state, EventKind::GameStarted);
+                started.source = getMapNumber(engine.getMap());
+                write(started);
+            }
+
+            EventRecord record = makeRecord(state, EventKind::StateChanged);
+            record.detail = static_cast<std::uint8_t>(engine.getState());
+            write(record);
+            break;
+        }
+        case GameEngine::Event::PlayerEliminated:
+        {
+            EventRecord record = makeRecord(state, EventKind::PlayerEliminated);
+            record.player = getPlayerNumber(player);
+            write(record);
+            break;
+        }
+        case GameEngine::Event::CardDrawn:
+        {
+            EventRecord record = makeRecord(state, EventKind::CardDrawn);
+            record.player = getPlayerNumber(player);
+            record.detail = static_cast<std::uint8_t>(event.card);
+            write(record);
+            break;
+        }
+    }
+}
+
+void EventLogObserver::update(const OrderEvent& event)
+{
+    const OrderData& order = event.order;
+    const OrderEffect& effect = event.effect;
+    bool added = event.added;
+    bool executed = event.executed;
+    EventLogThreadState& state = getThreadState(this);
+    EventRecord record = makeRecord(state, added ? EventKind::OrderIssued : EventKind::OrderExecuted);
+    record.detail = static_cast<std::uint8_t>(order.type);
+    record.flags = (order.cheat ? EventRecord::flagCheat : 0) | (executed ? EventRecord::flagExecuted : 0);
+    record.player = getPlayerNumber(order.player);
+    record.targetPlayer = getPlayerNumber(order.targetPlayer);
+    record.source = order.sourceTerritory == nullptr ? 0 : static_cast<std::uint16_t>(order.sourceTerritory->ID);
+    record.target = order.targetTerritory == nullptr ? 0 : static_cast<std::uint16_t>(order.targetTerritory->ID);
+    record.armies = order.armies;
+
+    if (added)
+    {
+        record.values[0] = effect.armiesBefore;
+        write(record);
+        return;
+    }
+
+    record.effect = static_cast<std::uint8_t>(effect.kind);
+    record.continent = effect.capturedContinent == nullptr ? 0 : static_cast<std::uint16_t>(effect.capturedContinent->ID);
+
+    switch (effect.kind)
+    {
+        case OrderEffect::Kind::Invalid:
+        {
+            record.values[0] = getReasonNumber(effect.reason);
+            break;
+        }
+        case OrderEffect::Kind::Attacked:
+        case OrderEffect::Kind::Conquered:
+        {
+            record.values[0] = effect.attackersLeft;
+            record.values[1] = effect.defendersLeft;
+            break;
+        }
+        case OrderEffect::Kind::Bombed:
+        case OrderEffect::Kind::Blockaded:
+        {
+            record.values[0] = effect.armiesBefore;
+            record.values[1] = effect.armiesAfter;
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
+
+    write(record);
+}
+
+void EventLogObserver::write(const EventRecord& record, const char* text, size_t length)
+{
+    // Queuing swaps the bytes with a string the writer thread is done with, so this normally doesn't allocate
+    std::string& bytes = threadState.bytes;
+    bytes.assign(reinterpret_cast<const char*>(&record), sizeof(record));
+    if (length > 0)
+    {
+        bytes.append(text, length);
+    }
+    enqueue(bytes);
+}
+
+void EventLogObserver::writeName(EventName name, std::uint32_t game, std::uint16_t ID, std::uint16_t mapNumber, const std::string& text, std::uint16_t continentID)
+{
+    EventRecord record = {};
+    record.game = game;
+    record.kind = EventKind::Name;
+    record.detail = static_cast<std::uint8_t>(name);
+    record.target = ID;
+    record.source = mapNumber;
+    record.continent = continentID;
+    record.values[0] = static_cast<std::int32_t>(text.size());
+    write(record, text.data(), text.size());
+}
+
+std::uint16_t EventLogObserver::getPlayerNumber(const Player* player)
+{
+    if (player == nullptr)
+    {
+        return 0;
+    }
+
+    EventLogThreadState& state = getThreadState(this);
+    std::vector<const Player*>::iterator it = std::find(state.players.begin(), state.players.end(), player);
+    if (it != state.players.end())
+    {
+        return static_cast<std::uint16_t>(it - state.players.begin() + 1);
+    }
+
+    state.players.push_back(player);
+    std::uint16_t number = static_cast<std::uint16_t>(state.players.size());
+    writeName(EventName::Player, state.game, number, 0, player->getName());
+    return number;
+}
+
+std::uint16_t EventLogObserver::getMapNumber(const Map& map)
+{
+    // Names are written while holding the lock, so that they come before any record of another thread using them
+    std::lock_guard<std::mutex> lock(namesMutex);
+
+    std::vector<std::string>::iterator it = std::find(mapNames.begin(), mapNames.end(), map.name);
+    if (it != mapNames.end())
+    {
+        return static_cast<std::uint16_t>(it - mapNames.begin() + 1);
+    }
+
+    mapNames.push_back(map.name);
+    std::uint16_t number = static_cast<std::uint16_t>(mapNames.size());
+
+    writeName(EventName::Map, 0, number, 0, map.name);
+    for (Continent* continent : map.continents)
+    {
+        writeName(EventName::Continent, 0, static_cast<std::uint16_t>(continent->ID), number, continent->name);
+    }
+    for (Territory* territory : map.territories)
+    {
+        writeName(EventName::Territory, 0, static_cast<std::uint16_t>(territory->ID), number, territory->name, static_cast<std::uint16_t>(territory->continentID));
+    }
+
+    return number;
+}
+
+std::int32_t EventLogObserver::getReasonNumber(const char* reason)
+{
+    std::lock_guard<std::mutex> lock(namesMutex);
+
+    std::vector<std::string>::iterator it = std::find(reasons.begin(), reasons.end(), reason);
+    if (it != reasons.end())
+    {
+        return static_cast<std::int32_t>(it - reasons.begin() + 1);
+    }
+
+    reasons.push_back(reason);
+    std::int32_t number = static_cast<std::int32_t>(reasons.size());
+    writeName(EventName::Reason, 0, static_cast<std::uint16_t>(number), 0, reason);
+    return number;
+}
+
+/* --- EventLogReader --- */
+
+// Checks that the territories and players an order is printed with are known
+static bool canPrint(const OrderData& order, const OrderEffect& effect)
+{
+    bool needsSource = false;
+    bool needsTarget = false;
+    bool needsPlayer = false;
+    bool needsTargetPlayer = false;
+
+    switch (effect.kind)
+    {
+        case OrderEffect::Kind::Issued:
+        {
+            // Described by the type of order
+            needsSource = order.type == OrderType::Advance || order.type == OrderType::Airlift;
+            needsTarget = order.type != OrderType::Order && order.type != OrderType::Negotiate;
+            needsTargetPlayer = order.type == OrderType::Negotiate;
+            break;
+        }
+        case OrderEffect::Kind::Moved:
+        case OrderEffect::Kind::Attacked:
+        case OrderEffect::Kind::Conquered:
+        case OrderEffect::Kind::Airlifted:
+        {
+            needsSource = true;
+            needsTarget = true;
+            break;
+        }
+        case OrderEffect::Kind::Cheated:
+        {
+            needsPlayer = true;
+            needsTarget = true;
+            break;
+        }
+        case OrderEffect::Kind::Deployed:
+        case OrderEffect::Kind::Bombed:
+        case OrderEffect::Kind::Blockaded:
+        {
+            needsTarget = true;
+            break;
+        }
+        case OrderEffect::Kind::Negotiated:
+        {
+            needsTargetPlayer = true;
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
+
+    return (!needsSource || order.sourceTerritory != nullptr) && (!needsTarget || order.targetTerritory != nullptr) &&
+           (!needsPlayer || order.player != nullptr) && (!needsTargetPlayer || order.targetPlayer != nullptr) &&
+           (effect.capturedContinent == nullptr || effect.capturingPlayer != nullptr);
+}
+
+EventLogReader::EventLogReader():
+    file(),
+    names(),
+    maps(),
+    games(),
+    gameMaps(),
+    reasons(),
+    bytesLeft(0),
+    entriesLeft(0),
+    corrupt(false)
+{
+
+}
+
+EventLogReader::EventLogReader(const EventLogReader& other):
+    EventLogReader()
+{
+
+}
+
+EventLogReader::~EventLogReader()
+{
+    for (MapNames& map : maps)
+    {
+        for (Continent* continent : map.continents)
+        {
+            delete continent;
+        }
+        for (Territory* territory : map.territories)
+        {
+            delete territory;
+        }
+    }
+
+    for (GameNames& game : games)
+    {
+        for (Player* player : game.players)
+        {
+            delete player;
+        }
+    }
+}
+
+EventLogReader& EventLogReader::operator = (const EventLogReader& other)
+{
+    return *this;
+}
+
+std::ostream& operator << (std::ostream& out, const EventLogReader& source)
+{
+    out << "EventLogReader maps: " << source.maps.size() << ", games: " << source.games.size();
+    return out;
+}
+
+bool EventLogReader::open(const std::string& filepath)
+{
+    file.open(filepath, std::ios_base::in | std::ios_base::binary);
+
+    // The size of the log bounds the lengths and numbers that its records can hold
+    std::streamoff size = file.seekg(0, std::ios_base::end).tellg();
+    file.seekg(0, std::ios_base::beg);
+
+    char fileHeader[sizeof(EventLogObserver::header)];
+    if (size < static_cast<std::streamoff>(sizeof(fileHeader)) || !file.read(fileHeader, sizeof(fileHeader)))
+    {
+        return false;
+    }
+
+    // Every name, and every game, has a record of its own: a log never names more entries than it has records
+    bytesLeft = static_cast<std::uint64_t>(size) - sizeof(fileHeader);
+    entriesLeft = bytesLeft / sizeof(EventRecord);
+
+    return std::equal(fileHeader, fileHeader + sizeof(fileHeader), EventLogObserver::header);
+}
+
+bool EventLogReader::next(EventRecord& record, std::string& text)
+{
+    text.clear();
+
+    if (bytesLeft == 0 || corrupt)
+    {
+        return false;
+    }
+    if (bytesLeft < sizeof(record) || !file.read(reinterpret_cast<char*>(&record), sizeof(record)))
+    {
+        return stop();
+    }
+    bytesLeft -= sizeof(record);
+
+    // Values that are used as indices must be in range, since the file may not have been written by EventLogObserver
+    bool valid = true;
+    switch (record.kind)
+    {
+        case EventKind::Name:
+        {
+            valid = record.detail <= static_cast<std::uint8_t>(EventName::Reason);
+            break;
+        }
+        case EventKind::Text:
+        case EventKind::GameStarted:
+        case EventKind::PlayerEliminated:
+        {
+            break;
+        }
+        case EventKind::StateChanged:
+        {
+            valid = record.detail < static_cast<std::uint8_t>(GameEngine::State::NumStates);
+            break;
+        }
+        case EventKind::CardDrawn:
+        {
+            valid = record.detail < static_cast<std::uint8_t>(Card::Type::NumTypes);
+            break;
+        }
+        case EventKind::OrderIssued:
+        case EventKind::OrderExecuted:
+        {
+            valid = record.detail <= static_cast<std::uint8_t>(OrderType::Negotiate) && record.effect <= static_cast<std::uint8_t>(OrderEffect::Kind::Negotiated);
+            break;
+        }
+        default:
+        {
+            valid = false;
+            break;
+        }
+    }
+    if (!valid)
+    {
+        return stop();
+    }
+
+    // Names and texts are followed by their characters
+    if (record.kind == EventKind::Name || record.kind == EventKind::Text)
+    {
+        if (record.values[0] < 0 || static_cast<std::uint64_t>(record.values[0]) > bytesLeft)
+        {
+            return stop();
+        }
+
+        text.resize(static_cast<size_t>(record.values[0]));
+        if (!file.read(&text[0], text.size()))
+        {
+            return stop();
+        }
+        bytesLeft -= text.size();
+    }
+
+    std::ostringstream stream;
+
+    switch (record.kind)
+    {
+        case EventKind::Name:
+        {
+            bool added = addName(record, text);
+            text.clear();
+            return added || stop();
+        }
+        case EventKind::Text:
+        {
+            return true;
+        }
+        case EventKind::GameStarted:
+        {
+            if (record.game >= games.size())
+            {
+                if (!growTable(games.size(), static_cast<size_t>(record.game) + 1))
+                {
+                    return stop();
+                }
+                games.resize(record.game + 1);
+                gameMaps.resize(record.game + 1, 0);
+            }
+
+            // Players are numbered again in every game
+            for (Player* player : games[record.game].players)
+            {
+                delete player;
+            }
+            games[record.game].players.clear();
+            gameMaps[record.game] = record.source;
+            return true;
+        }
+        case EventKind::StateChanged:
+        {
+            GameEngine::printEvent(stream, GameEngine::Event::StateChanged, static_cast<GameEngine::State>(record.detail), "", Card::Type::Bomb);
+            break;
+        }
+        case EventKind::PlayerEliminated:
+        {
+            GameEngine::printEvent(stream, GameEngine::Event::PlayerEliminated, GameEngine::State::Start, getPlayerName(record.game, record.player), Card::Type::Bomb);
+            break;
+        }
+        case EventKind::CardDrawn:
+        {
+            GameEngine::printEvent(stream, GameEngine::Event::CardDrawn, GameEngine::State::Start, getPlayerName(record.game, record.player), static_cast<Card::Type>(record.detail));
+            break;
+        }
+        case EventKind::OrderIssued:
+        {
+            OrderEffect effect;
+            effect.kind = OrderEffect::Kind::Issued;
+            effect.armiesBefore = record.values[0];
+
+            OrderData order = getOrder(record);
+            if (!canPrint(order, effect))
+            {
+                return stop();
+            }
+
+            stream << "OrdersList new element: ";
+            order.print(stream, false, effect);
+            break;
+        }
+        case EventKind::OrderExecuted:
+        {
+            OrderData order = getOrder(record);
+
+            OrderEffect effect;
+            effect.kind = static_cast<OrderEffect::Kind>(record.effect);
+            switch (effect.kind)
+            {
+                case OrderEffect::Kind::Invalid:
+                {
+                    size_t reason = static_cast<size_t>(record.values[0]);
+                    effect.reason = reason >= 1 && reason <= reasons.size() ? reasons[reason - 1].c_str() : "";
+                    break;
+                }
+                case OrderEffect::Kind::Attacked:
+                case OrderEffect::Kind::Conquered:
+                {
+                    effect.attackersLeft = record.values[0];
+                    effect.defendersLeft = record.values[1];
+                    break;
+                }
+                case OrderEffect::Kind::Bombed:
+                case OrderEffect::Kind::Blockaded:
+                {
+                    effect.armiesBefore = record.values[0];
+                    effect.armiesAfter = record.values[1];
+                    break;
+                }
+                default:
+                {
+                    break;
+                }
+            }
+
+            // A blockade gives the territory, and maybe its continent, to the neutral player
+            effect.capturedContinent = getContinent(getGameMap(record.game), record.continent);
+            effect.capturingPlayer = order.type == OrderType::Blockade ? order.targetPlayer : order.player;
+            if (!canPrint(order, effect))
+            {
+                return stop();
+            }
+
+            order.print(stream, (record.flags & EventRecord::flagExecuted) != 0, effect);
+            break;
+        }
+    }
+
+    text = stream.str();
+    return true;
+}
+
+bool EventLogReader::isCorrupt() const
+{
+    return corrupt;
+}
+
+bool EventLogReader::stop()
+{
+    corrupt = true;
+    return false;
+}
+
+bool EventLogReader::growTable(size_t size, size_t newSize)
+{
+    if (newSize <= size)
+    {
+        return true;
+    }
+    if (newSize - size > entriesLeft)
+    {
+        return false;
+    }
+    entriesLeft -= newSize - size;
+    return true;
+}
+
+const std::string& EventLogReader::getPlayerName(std::uint32_t game, std::uint16_t player) const
+{
+    static const std::string unknown;
+
+    Player* result = getPlayer(game, player);
+    return result == nullptr ? unknown : result->getName();
+}
+
+bool EventLogReader::addName(const EventRecord& record, const std::string& text)
+{
+    switch (static_cast<EventName>(record.detail))
+    {
+        case EventName::Map:
+        {
+            if (record.target > maps.size())
+            {
+                if (!growTable(maps.size(), record.target))
+                {
+                    return false;
+                }
+                maps.resize(record.target);
+            }
+            break;
+        }
+        case EventName::Continent:
+        case EventName::Territory:
+        {
+            if (record.source == 0 || record.source > maps.size() || record.target == 0)
+            {
+                break;
+            }
+
+            // Continents and territories point to their names, which must stay in place
+            names.push_back(text);
+            const char* name = names.back().c_str();
+
+            MapNames& map = maps[record.source - 1];
+            if (static_cast<EventName>(record.detail) == EventName::Continent)
+            {
+                if (record.target > map.continents.size())
+                {
+                    if (!growTable(map.continents.size(), record.target))
+                    {
+                        return false;
+                    }
+                    map.continents.resize(record.target, nullptr);
+                }
+                delete map.continents[record.target - 1];
+                map.continents[record.target - 1] = new Continent(record.target, name, "", 0);
+            }
+            else
+            {
+                if (record.target > map.territories.size())
+                {
+                    if (!growTable(map.territories.size(), record.target))
+                    {
+                        return false;
+                    }
+                    map.territories.resize(record.target, nullptr);
+                }
+                // Continents are named before their territories
+                Continent* continent = record.continent == 0 || record.continent > map.continents.size() ? nullptr : map.continents[record.continent - 1];
+                if (continent == nullptr)
+                {
+                    break;
+                }
+                delete map.territories[record.target - 1];
+                map.territories[record.target - 1] = new Territory(record.target, name, continent, 0, 0);
+            }
+            break;
+        }
+        case EventName::Player:
+        {
+            if (record.game >= games.size())
+            {
+                if (!growTable(games.size(), static_cast<size_t>(record.game) + 1))
+                {
+                    return false;
+                }
+                games.resize(record.game + 1);
+                gameMaps.resize(record.game + 1, 0);
+            }
+
+            std::vector<Player*>& players = games[record.game].players;
+            if (record.target > players.size())
+            {
+                if (!growTable(players.size(), record.target))
+                {
+                    return false;
+                }
+                players.resize(record.target, nullptr);
+            }
+            if (record.target > 0)
+            {
+                delete players[record.target - 1];
+                players[record.target - 1] = new Player();
+                players[record.target - 1]->setName(text);
+            }
+            break;
+        }
+        case EventName::Reason:
+        {
+            if (record.target > reasons.size())
+            {
+                if (!growTable(reasons.size(), record.target))
+                {
+                    return false;
+                }
+                reasons.resize(record.target);
+            }
+            if (record.target > 0)
+            {
+                reasons[record.target - 1] = text;
+            }
+            break;
+        }
+    }
+    return true;
+}
+
+Continent* EventLogReader::getContinent(std::uint16_t mapNumber, std::uint16_t ID) const
+{
+    if (mapNumber == 0 || mapNumber > maps.size() || ID == 0 || ID > maps[mapNumber - 1].continents.size())
+    {
+        return nullptr;
+    }
+    return maps[mapNumber - 1].continents[ID - 1];
+}
+
+Territory* EventLogReader::getTerritory(std::uint16_t mapNumber, std::uint16_t ID) const
+{
+    if (mapNumber == 0 || mapNumber > maps.size() || ID == 0 || ID > maps[mapNumber - 1].territories.size())
+    {
+        return nullptr;
+    }
+    return maps[mapNumber - 1].territories[ID - 1];
+}
+
+Player* EventLogReader::getPlayer(std::uint32_t game, std::uint16_t player) const
+{
+    if (game >= games.size() || player == 0 || player > games[game].players.size())
+    {
+        return nullptr;
+    }
+    return games[game].players[player - 1];
+}
+
+std::uint16_t EventLogReader::getGameMap(std::uint32_t game) const
+{
+    return game < gameMaps.size() ? gameMaps[game] : 0;
+}
+
+OrderData EventLogReader::getOrder(const EventRecord& record) const
+{
+    std::uint16_t mapNumber = getGameMap(record.game);
+
+    OrderData order;
+    order.type = static_cast<OrderType>(record.detail);
+    order.cheat = (record.flags & EventRecord::flagCheat) != 0;
+    order.armies = record.armies;
+    order.player = getPlayer(record.game, record.player);
+    order.targetPlayer = getPlayer(record.game, record.targetPlayer);
+    order.sourceTerritory = getTerritory(mapNumber, record.source);
+    order.targetTerritory = getTerritory(mapNumber, record.target);
+    return order;
+}
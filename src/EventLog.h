@@ -0,0 +1,212 @@
+#pragma once
+#include "LoggingObserver.h"
+
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Forward declarations
+class Continent;
+class Map;
+class Player;
+class Territory;
+struct OrderData;
+
+// Kinds of records in a binary event log
+enum class EventKind : std::uint8_t
+{
+    Name,                   // Defines the name of a map, continent, territory, player or invalid order reason
+    Text,                   // Line of text, for what has no record of its own (ex: commands)
+    GameStarted,            // A game started on a map
+    StateChanged,           // The game engine changed state
+    PlayerEliminated,       // A player lost their last territory
+    CardDrawn,              // A player drew a card
+    OrderIssued,            // An order was added to a player's orders
+    OrderExecuted           // An order was executed, or found invalid when it was about to be
+};
+
+// Kinds of names defined by EventKind::Name records
+enum class EventName : std::uint8_t
+{
+    Map,
+    Continent,
+    Territory,
+    Player,
+    Reason
+};
+
+// Fixed-size record of a binary event log, in native byte order.
+// Players are numbered from 1 in each game, and territories and continents use their IDs (0 means none).
+// Fields used by each kind of record:
+// - Name: detail (EventName), target (the ID that is named: map number, continent or territory ID, player number, reason number),
+//   source (map number of a continent or territory), continent (continent ID of a territory), values[0] (length of the name, which follows the record)
+// - Text: values[0] (length of the text, which follows the record)
+// - GameStarted: source (map number)
+// - StateChanged: detail (GameEngine::State)
+// - PlayerEliminated: player
+// - CardDrawn: player, detail (Card::Type)
+// - OrderIssued: detail (OrderType), flags, player, targetPlayer, source, target, armies, values[0] (armies on the target territory)
+// - OrderExecuted: same as OrderIssued, with effect (OrderEffect::Kind), continent (captured continent) and values that depend on the effect:
+//   Invalid: values[0] (reason number), Attacked and Conquered: attackers then defenders left, Bombed and Blockaded: armies before then after
+struct EventRecord
+{
+    std::uint32_t game;                 // Game the event belongs to (its round, in tournaments)
+    std::uint16_t turn;                 // Turn of the game
+    EventKind kind;                     // Kind of record
+    std::uint8_t detail;                // Depends on the kind
+    std::uint8_t effect;                // OrderExecuted: kind of effect
+    std::uint8_t flags;                 // Order events: combination of flagCheat and flagExecuted
+    std::uint16_t player;               // Player the event is about
+    std::uint16_t targetPlayer;         // Other player of an order
+    std::uint16_t source;               // Source territory of an order
+    std::uint16_t target;               // Target territory of an order
+    std::uint16_t continent;            // Continent captured by an order
+    std::int32_t armies;                // Armies of an order
+    std::int32_t values[2];             // Depends on the kind
+
+    static const std::uint8_t flagCheat = 1;        // Advance regardless of the game rules
+    static const std::uint8_t flagExecuted = 2;     // The order was valid and executed
+};
+
+// Writes a binary event log: a header, then one EventRecord per event.
+// Records of a game are keyed by the game index and turn of the GameContext of the engine playing it.
+// Orders are keyed by the last event of the engine running on the same thread, since an engine plays its games on a single thread.
+// Names are written the first time they are needed, before the record that needs them.
+class EventLogObserver : public LogObserver
+{
+public:
+
+    // Default constructor (writes to "gamelog.wzlog")
+    EventLogObserver();
+    // Parametrized constructor
+    EventLogObserver(const std::string& filepath);
+    // Destructor
+    ~EventLogObserver();
+
+    // Stream output operator
+    friend std::ostream& operator << (std::ostream& out, const EventLogObserver& source);
+
+    // Subscribes to the events that are logged, instead of LogObserver's text lines
+    void subscribe() override;
+    // Unsubscribes from the events that are logged
+    void unsubscribe() override;
+    // Update methods called by the EventBus, which write the events as records
+    void update(const CommandEvent& event);
+    void update(const EngineEvent& event);
+    void update(const OrderEvent& event);
+
+    // Writes a line of text
+    void writeText(const std::string& line);
+
+    // Bytes at the start of every event log
+    static const char header[8];
+
+private:
+
+    // Copy constructor
+    EventLogObserver(const EventLogObserver& other);
+    // Assignment operator
+    EventLogObserver& operator = (const EventLogObserver& other);
+
+    // Writes a record, followed by a text of the given length
+    void write(const EventRecord& record, const char* text = nullptr, size_t length = 0);
+    // Writes a Name record
+    void writeName(EventName name, std::uint32_t game, std::uint16_t ID, std::uint16_t mapNumber, const std::string& text, std::uint16_t continentID = 0);
+    // Returns the number of a player in the game played on this thread, naming the player the first time
+    std::uint16_t getPlayerNumber(const Player* player);
+    // Returns the number of a map, naming it and its continents and territories the first time
+    std::uint16_t getMapNumber(const Map& map);
+    // Returns the number of an invalid order reason, naming it the first time
+    std::int32_t getReasonNumber(const char* reason);
+
+    // Protects the names shared by all threads
+    std::mutex namesMutex;
+    // Names of the maps, by map number - 1
+    std::vector<std::string> mapNames;
+    // Invalid order reasons, by reason number - 1
+    std::vector<std::string> reasons;
+};
+
+// Reads a binary event log, and renders its records as the text that LogObserver would have logged
+class EventLogReader
+{
+public:
+
+    // Default constructor
+    EventLogReader();
+    // Destructor
+    ~EventLogReader();
+
+    // Stream output operator
+    friend std::ostream& operator << (std::ostream& out, const EventLogReader& source);
+
+    // Opens an event log. Returns false if the file can't be read or isn't an event log.
+    bool open(const std::string& filepath);
+
+    // Reads the next record, and renders it in text (empty for records that aren't logged as text, ex: names).
+    // Returns false at the end of the log, or at a record that isn't valid (see isCorrupt).
+    bool next(EventRecord& record, std::string& text);
+
+    // Checks if reading stopped at a record that isn't valid, or that the log ends in the middle of
+    bool isCorrupt() const;
+
+    // Returns the name of a player of a game (empty if unknown)
+    const std::string& getPlayerName(std::uint32_t game, std::uint16_t player) const;
+
+private:
+
+    // Copy constructor
+    EventLogReader(const EventLogReader& other);
+    // Assignment operator
+    EventLogReader& operator = (const EventLogReader& other);
+
+    // Continents and territories of a map, by ID - 1
+    struct MapNames
+    {
+        std::vector<Continent*> continents;
+        std::vector<Territory*> territories;
+    };
+
+    // Players of a game, by player number - 1
+    struct GameNames
+    {
+        std::vector<Player*> players;
+    };
+
+    // Records a name. Returns false if the name can't be recorded.
+    bool addName(const EventRecord& record, const std::string& text);
+    // Checks that a table of names can grow to a new size, and takes the new entries off entriesLeft
+    bool growTable(size_t size, size_t newSize);
+    // Marks the log as corrupt, and returns false
+    bool stop();
+    // Returns the continent or territory of a map, nullptr if unknown
+    Continent* getContinent(std::uint16_t mapNumber, std::uint16_t ID) const;
+    Territory* getTerritory(std::uint16_t mapNumber, std::uint16_t ID) const;
+    // Returns a player of a game, nullptr if unknown
+    Player* getPlayer(std::uint32_t game, std::uint16_t player) const;
+    // Returns the map number of a game
+    std::uint16_t getGameMap(std::uint32_t game) const;
+    // Rebuilds the order of an order record
+    OrderData getOrder(const EventRecord& record) const;
+
+    std::ifstream file;
+    // Names that continents and territories point to
+    std::deque<std::string> names;
+    // By map number - 1
+    std::vector<MapNames> maps;
+    // By game index
+    std::vector<GameNames> games;
+    // Map number of each game, by game index
+    std::vector<std::uint16_t> gameMaps;
+    // By reason number - 1
+    std::vector<std::string> reasons;
+    // Bytes of the log that weren't read yet
+    std::uint64_t bytesLeft;
+    // Entries that the tables of names and games can still grow by
+    std::uint64_t entriesLeft;
+    // Reading stopped at a record that isn't valid
+    bool corrupt;
+};
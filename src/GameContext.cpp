@@ -0,0 +1,122 @@
+#include "GameContext.h"
+#include "Player.h"
+
+#include <random>
+
+/* --- GameContext --- */
+
+GameContext::GameContext():
+    deck(),
+    random((static_cast<std::uint64_t>(std::random_device()()) << 32) | std::random_device()()),
+    neutralPlayer(new Player()),
+    turnIndex(0),
+    gameStartTurn(0),
+    gameIndex(0)
+{
+    neutralPlayer->setName("Neutral");
+}
+
+// The neutral player is not shared, the copy gets a fresh one
+GameContext::GameContext(const GameContext& other):
+    deck(other.deck),
+    random(other.random),
+    neutralPlayer(new Player()),
+    turnIndex(other.turnIndex),
+    gameStartTurn(other.gameStartTurn),
+    gameIndex(other.gameIndex)
+{
+    neutralPlayer->setName(other.neutralPlayer->getName());
+}
+
+GameContext::~GameContext()
+{
+    delete neutralPlayer;
+}
+
+// The neutral player is not shared, this context keeps its own
+GameContext& GameContext::operator = (const GameContext& other)
+{
+    deck = other.deck;
+    random = other.random;
+    neutralPlayer->setName(other.neutralPlayer->getName());
+    turnIndex = other.turnIndex;
+    gameStartTurn = other.gameStartTurn;
+    gameIndex = other.gameIndex;
+    return *this;
+}
+
+std::ostream& operator << (std::ostream& out, const GameContext& source)
+{
+    out << "turn: " << source.turnIndex << ", " << source.deck;
+    return out;
+}
+
+Deck& GameContext::getDeck()
+{
+    return deck;
+}
+
+Player& GameContext::getNeutralPlayer()
+{
+    return *neutralPlayer;
+}
+
+Random& GameContext::getRandom()
+{
+    return random;
+}
+
+void GameContext::seed(std::uint64_t seed, std::uint64_t stream)
+{
+    random.seed(seed);
+    for (std::uint64_t i = 0; i < stream; ++i)
+    {
+        random.jump();
+    }
+}
+
+int GameContext::randomInt(int bound)
+{
+    return random.nextInt(bound);
+}
+
+float GameContext::random01()
+{
+    return random.nextFloat();
+}
+
+int GameContext::getTurnIndex() const
+{
+    return turnIndex;
+}
+
+void GameContext::nextTurn()
+{
+    turnIndex++;
+}
+
+int GameContext::getGameTurn() const
+{
+    return turnIndex - gameStartTurn;
+}
+
+std::uint32_t GameContext::getGameIndex() const
+{
+    return gameIndex;
+}
+
+void GameContext::setGameIndex(std::uint32_t gameIndex)
+{
+    this->gameIndex = gameIndex;
+}
+
+void GameContext::reset()
+{
+    deck.releaseAllocs();
+
+    delete neutralPlayer;
+    neutralPlayer = new Player();
+    neutralPlayer->setName("Neutral");
+
+    gameStartTurn = turnIndex;
+}
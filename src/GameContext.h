@@ -0,0 +1,86 @@
+#pragma once
+#include "Cards.h"
+#include "Random.h"
+
+#include <cstdint>
+#include <ostream>
+
+// Forward declarations
+class Player;
+
+// Holds the state shared by everything taking part in a single game: deck, random number generator,
+// neutral player and turn counter. Each GameEngine owns one, and hands it to the orders and cards it plays,
+// so that several games can run in the same process without interfering with each other.
+class GameContext
+{
+public:
+
+    // Default constructor
+    GameContext();
+    // Copy constructor
+    GameContext(const GameContext& other);
+    // Destructor
+    ~GameContext();
+
+    // Assignment operator
+    GameContext& operator = (const GameContext& other);
+    // Stream output operator
+    friend std::ostream& operator << (std::ostream& out, const GameContext& source);
+
+    // Returns the deck of this game
+    Deck& getDeck();
+
+    // Returns the neutral player of this game
+    Player& getNeutralPlayer();
+
+    // Returns the random number generator of this game
+    Random& getRandom();
+
+    // Seeds the random number generator. Each stream of a given seed is an independent sequence,
+    // which lets every game of a tournament be replayed on its own.
+    void seed(std::uint64_t seed, std::uint64_t stream = 0);
+
+    // Returns a uniformly distributed integer in [0, bound)
+    int randomInt(int bound);
+
+    // Returns a uniformly distributed float in [0, 1)
+    float random01();
+
+    // Incremented every turn
+    // Doesn't get reset between games
+    int getTurnIndex() const;
+
+    // Increments the turn counter
+    void nextTurn();
+
+    // Returns the number of turns played in the current game
+    int getGameTurn() const;
+
+    // Identifies the game in logs (its round, in tournaments). Isn't changed by reset.
+    std::uint32_t getGameIndex() const;
+    void setGameIndex(std::uint32_t gameIndex);
+
+    // Releases the deck's cards and replaces the neutral player, in preparation for a new game
+    void reset();
+
+private:
+
+    // Cards that players draw from, and return played cards to
+    Deck deck;
+
+    // Random number generator used for territory assignment, card draws and battles
+    Random random;
+
+    // Neutral player
+    Player* neutralPlayer;
+
+    // Incremented every turn
+    // Doesn't get reset between games
+    int turnIndex;
+
+    // Value of turnIndex when the current game started
+    int gameStartTurn;
+
+    // Identifies the game in logs
+    std::uint32_t gameIndex;
+};
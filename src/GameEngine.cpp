@@ -5,9 +5,11 @@
 #include "PlayerStrategies.h"
 
 #include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <random>
 #include <sstream>
+#include <thread>
 #include <cmath>
 
 
@@ -63,10 +65,13 @@ GameEngine::GameEngine():
     map(new Map()),
     players(),
     alivePlayers(),
-    eliminatedPlayers()
+    eliminatedPlayers(),
+    context(),
+    turnOrders(),
+    doneIssuing(),
+    issuingPlayers()
 {
-    neutralPlayer = new Player();
-    neutralPlayer->setName("Neutral");
+
 }
 
 GameEngine::~GameEngine()
@@ -79,23 +84,24 @@ void GameEngine::cleanup(bool prepareNewGame)
     if (prepareNewGame)
     {
         map->releaseAllocs();
-        mainDeck.releaseAllocs();
-
-        players.clear();
-        alivePlayers.clear();
-        eliminatedPlayers.clear();
 
-        delete neutralPlayer;
-        neutralPlayer = new Player();
-        neutralPlayer->setName("Neutral");
+        resetGameState();
     }
     else
     {
         delete map;
-        delete neutralPlayer;
     }
 }
 
+void GameEngine::resetGameState()
+{
+    players.clear();
+    alivePlayers.clear();
+    eliminatedPlayers.clear();
+
+    context.reset();
+}
+
 ostream& operator << (ostream& out, const GameEngine& source)
 {
     out << "state: " << source.state;
@@ -106,9 +112,12 @@ GameEngine::GameEngine(const GameEngine& other):
     state(other.state),
     map(other.map),
     players(other.players),
-    neutralPlayer(other.neutralPlayer),
     alivePlayers(other.alivePlayers),
-    eliminatedPlayers(other.eliminatedPlayers)
+    eliminatedPlayers(other.eliminatedPlayers),
+    context(other.context),
+    turnOrders(other.turnOrders),
+    doneIssuing(other.doneIssuing),
+    issuingPlayers(other.issuingPlayers)
 {
 
 }
@@ -118,9 +127,12 @@ GameEngine& GameEngine::operator = (const GameEngine& other)
     state = other.state;
     map = other.map;
     players = other.players;
-    neutralPlayer = other.neutralPlayer;
     alivePlayers = other.alivePlayers;
     eliminatedPlayers = other.eliminatedPlayers;
+    context = other.context;
+    turnOrders = other.turnOrders;
+    doneIssuing = other.doneIssuing;
+    issuingPlayers = other.issuingPlayers;
     return *this;
 }
 
@@ -141,8 +153,8 @@ bool GameEngine::transition(State state)
     if (getStateInfo().canDoState(state))
     {
         this->state = state;
-        // Notify the observers of the GameEngine state change
-        notify();
+        // Publish the GameEngine state change
+        publishEvent(Event::StateChanged);
         return true;
     }
     else
@@ -158,8 +170,8 @@ bool GameEngine::transition(Transition transition)
     if (getStateInfo().canDoTransition(transition, newState))
     {
         this->state = newState;
-        // Notify the observers of the GameEngine state change
-        notify();
+        // Publish the GameEngine state change
+        publishEvent(Event::StateChanged);
         return true;
     }
     else
@@ -190,7 +202,12 @@ vector<Player*>& GameEngine::getEliminatedPlayers()
 
 Player& GameEngine::getNeutralPlayer()
 {
-    return *neutralPlayer;
+    return context.getNeutralPlayer();
+}
+
+GameContext& GameEngine::getContext()
+{
+    return context;
 }
 
 bool GameEngine::addPlayer(Player& player, bool canRename)
@@ -214,12 +231,6 @@ bool GameEngine::addPlayer(Player& player, bool canRename)
         }
     }
 
-    // Attach our observers
-    for (Observer* observer : observers)
-    {
-        player.getOrders()->attach(*observer);
-    }
-
     players.push_back(&player);
     alivePlayers.push_back(&player);
 
@@ -238,14 +249,6 @@ bool GameEngine::start(string mapFilepath, vector<Player*>& players)
     Command validateMap(Command::Type::ValidateMap);
     Command gameStart(Command::Type::GameStart);
 
-    // Attach our observers
-    for (Observer* observer : observers)
-    {
-        loadMap.attach(*observer);
-        validateMap.attach(*observer);
-        gameStart.attach(*observer);
-    }
-
     bool success = true;
 
     success = success && executeCommand(loadMap);
@@ -262,6 +265,32 @@ bool GameEngine::start(string mapFilepath, vector<Player*>& players)
     return success;
 }
 
+bool GameEngine::start(const Map& loadedMap, vector<Player*>& players)
+{
+    // Cleanup memory from previous game, except for the map that gets overwritten
+    resetGameState();
+    map->assign(loadedMap);
+
+    // Reset state, the map is already loaded and validated
+    state = State::Start;
+    transition(Transition::LoadMap);
+    transition(Transition::ValidateMap);
+
+    Command gameStart(Command::Type::GameStart);
+
+    bool success = true;
+
+    for (Player* player : players)
+    {
+        success = success && addPlayer(*player, true);
+        transition(Transition::AddPlayer);
+    }
+
+    success = success && executeCommand(gameStart);
+
+    return success;
+}
+
 bool GameEngine::executeCommand(Command& command)
 {
     switch (command.getType())
@@ -308,126 +337,126 @@ bool GameEngine::executeCommand(Command& command)
                 return false;
             }
 
-            vector<string> winningStrategies;
+            if (data->threads < 1)
+            {
+                std::ostringstream stream;
+                stream << "Must have at least 1 thread, got: " << data->threads;
 
-            for (int game = 0; game < data->games; ++game)
+                command.saveEffect(stream.str());
+                return false;
+            }
+
+            // Make sure the maps are unique
+            for (const string& map : data->maps)
+            {
+                if (count(data->maps.begin(), data->maps.end(), map) > 1)
+                {
+                    command.saveEffect("Duplicate map provided: " + map);
+                    return false;
+                }
+            }
+
+            // Make sure the player strategies are known and unique
+            for (const string& strategy : data->strategies)
+            {
+                PlayerStrategy* playerStrategy = createPlayerStrategy(strategy, context.getNeutralPlayer());
+                if (playerStrategy == nullptr)
+                {
+                    command.saveEffect("Unknown player strategy: " + strategy);
+                    state = State::Start;
+                    return false;
+                }
+                delete playerStrategy;
+
+                if (count(data->strategies.begin(), data->strategies.end(), strategy) > 1)
+                {
+                    command.saveEffect("Duplicate player strategies provided: " + strategy);
+                    state = State::Start;
+                    return false;
+                }
+            }
+
+            // Load and validate every map once, games then play on copies of them
+            vector<Map> tournamentMaps(numMaps);
+            for (size_t map = 0; map < numMaps; ++map)
             {
-                for (const string& map : data->maps)
+                int errorLine;
+                MapLoader mapLoader;
+                Map::FormatError result = mapLoader.load(data->maps.at(map), tournamentMaps.at(map), errorLine);
+                if (result == Map::FormatError::None)
                 {
-                    // Make sure the map is unique
-                    int mapCount = 0;
-                    for (const string& otherMap : data->maps)
-                    {
-                        if (otherMap == map)
-                        {
-                            mapCount++;
-                        }
-                    }
-                    if (mapCount > 1)
-                    {
-                        command.saveEffect("Duplicate map provided: " + map);
-                        return false;
-                    }
-
-                    vector<Player*> roundPlayers;
-
-                    // Assign player strategy
-                    for (const string& strategy : data->strategies)
-                    {
-                        Player* player = new Player();
-                        roundPlayers.push_back(player);
-
-                        if (strategy == "aggressive")
-                        {
-                            AggressivePlayerStrategy* aggressiveStrategy = new AggressivePlayerStrategy(*player);
-                            player->setPlayerStrategy(*aggressiveStrategy);
-                        }
-                        else if (strategy == "benevolent")
-                        {
-                            BenevolentPlayerStrategy* benevolentStrategy = new BenevolentPlayerStrategy(*player);
-                            player->setPlayerStrategy(*benevolentStrategy);
-                        }
-                        else if (strategy == "neutral")
-                        {
-                            NeutralPlayerStrategy* neutralStrategy = new NeutralPlayerStrategy(*player);
-                            player->setPlayerStrategy(*neutralStrategy);
-                        }
-                        else if (strategy == "cheater")
-                        {
-                            CheaterPlayerStrategy* cheaterStrategy = new CheaterPlayerStrategy(*player);
-                            player->setPlayerStrategy(*cheaterStrategy);
-                        }
-                        else
-                        {
-                            for (Player* player : roundPlayers)
-                            {
-                                delete player;
-                            }
-                            command.saveEffect("Unknown player strategy: " + strategy);
-                            state = State::Start;
-                            return false;
-                        }
-
-                        player->setName(StringUtils::strategyToString(player->getPlayerStrategy()));
-
-                        // Make sure the player strategy is unique
-                        for (const Player* otherPlayer : roundPlayers)
-                        {
-                            if (otherPlayer != player && otherPlayer->getName() == player->getName())
-                            {
-                                for (Player* player : roundPlayers)
-                                {
-                                    delete player;
-                                }
-                                command.saveEffect("Duplicate player strategies provided: " + strategy);
-                                state = State::Start;
-                                return false;
-                            }
-                        }
-                    }
-
-                    // Load map, set players, initial setup
-                    if (start(map, roundPlayers))
-                    {
-                        string winningStrategy = "Draw";
-
-                        // Run until we have a draw at maxTurns or a winner
-                        for (int turn = 0; turn < data->maxTurns && alivePlayers.size() > 1; ++turn)
-                        {
-                            executeTurn();
-                        }
-
-                        // Reset state
-                        state = State::Start;
-
-                        // Determine winner
-                        if (alivePlayers.size() == 1)
-                        {
-                            std::ostringstream stream;
-                            stream << StringUtils::strategyToString(alivePlayers.front()->getPlayerStrategy());
-                            winningStrategy = stream.str();
-                        }
-
-                        winningStrategies.push_back(winningStrategy);
-                    }
-                    else
-                    {
-                        for (Player* player : roundPlayers)
-                        {
-                            delete player;
-                        }
-                        command.saveEffect("Couldn't start round");
-                        state = State::Start;
-                        return false;
-                    }
-
-                    for (Player* player : roundPlayers)
-                    {
-                        delete player;
-                    }
+                    result = tournamentMaps.at(map).validate();
+                }
+
+                if (result != Map::FormatError::None)
+                {
+                    std::ostringstream stream;
+                    stream << "Couldn't load map " << data->maps.at(map) << ": " << result;
+
+                    command.saveEffect(stream.str());
+                    state = State::Start;
+                    return false;
                 }
             }
 
+            // Pick a seed if none was provided, so that the tournament can still be replayed
+            if (!data->hasSeed)
+            {
+                random_device device;
+                data->seed = (static_cast<uint64_t>(device()) << 32) | device();
+                data->hasSeed = true;
+            }
+
+            // Every (game, map) pair is an independent game, stored at index game * numMaps + map
+            size_t numRounds = data->games * numMaps;
+            vector<string> winningStrategies(numRounds);
+            // Not a vector<bool>, since its elements are written concurrently
+            vector<char> roundStarted(numRounds, false);
+            atomic<size_t> nextRound(0);
+            atomic<uint64_t> turnsPlayed(0);
+
+            // Each worker owns its own engine (and through it, its own map, players and deck)
+            // and keeps pulling the next unplayed round until there are none left
+            auto worker = [&]()
+            {
+                GameEngine engine;
+                uint64_t workerTurns = 0;
+
+                for (size_t round = nextRound++; round < numRounds; round = nextRound++)
+                {
+                    const Map& map = tournamentMaps.at(round % numMaps);
+
+                    // Each round draws from its own stream of the tournament seed,
+                    // so results don't depend on which worker plays it
+                    engine.getContext().seed(data->seed, round);
+                    engine.getContext().setGameIndex(static_cast<uint32_t>(round));
+                    roundStarted[round] = engine.playTournamentGame(map, data->strategies, data->maxTurns, winningStrategies[round]);
+                    workerTurns += engine.getContext().getGameTurn();
+                }
+
+                turnsPlayed += workerTurns;
+            };
+
+            size_t numThreads = min(static_cast<size_t>(data->threads), numRounds);
+            vector<thread> workers;
+            for (size_t i = 0; i < numThreads; ++i)
+            {
+                workers.emplace_back(worker);
+            }
+            for (thread& workerThread : workers)
+            {
+                workerThread.join();
+            }
+
+            state = State::Start;
+            data->turnsPlayed = turnsPlayed;
+
+            if (find(roundStarted.begin(), roundStarted.end(), false) != roundStarted.end())
+            {
+                command.saveEffect("Couldn't start round");
+                return false;
+            }
+
             // Create a formatted results table
             std::ostringstream stream;
             stream << endl << endl;
@@ -550,21 +579,20 @@ bool GameEngine::executeCommand(Command& command)
             }
 
             // Will help assign a random territory to a player
-            vector<Territory*> copyTerritories = map->territories;
+            vector<Territory*> copyTerritories(map->territories.begin(), map->territories.end());
             int territoryRand; // Will store a random index to a territory
 
             for (size_t i = 0; i < map->territories.size(); i++)
             {
-                territoryRand = rand() % copyTerritories.size(); // Generate the random index of the territory
+                territoryRand = context.randomInt(static_cast<int>(copyTerritories.size())); // Generate the random index of the territory
                 Territory* territory = copyTerritories.at(territoryRand); // Store the specific territory
                 Player* playerToAssign = players.at(i % players.size());
-                territory->player = playerToAssign;
                 playerToAssign->addTerritory(territory);
                 copyTerritories.erase(copyTerritories.begin() + territoryRand); // Will delete the territory assigned from the temporary vector
             }
 
             // Shuffle in a random manner the order of players
-            std::shuffle(players.begin(), players.end(), std::default_random_engine());
+            context.getRandom().shuffle(players);
 
             // Gives the players 50 armies
             for (Player* player : players)
@@ -573,7 +601,8 @@ bool GameEngine::executeCommand(Command& command)
             }
 
             // Initialize deck with 50 randomly shuffled cards (of even card type distribution)
-            mainDeck.addRandomCards(50);
+            Deck& deck = context.getDeck();
+            deck.addRandomCards(50);
 
             //Allows players to draw 2 cards from the deck
             for (Player* player : players)
@@ -581,7 +610,9 @@ bool GameEngine::executeCommand(Command& command)
                 Hand& hand = *player->getCards();
                 for (int i = 0; i < 2; i++)
                 {
-                    hand.addCard(*mainDeck.draw());
+                    Card& card = *deck.draw(context.getRandom());
+                    hand.addCard(card);
+                    publishEvent(Event::CardDrawn, player, card.getType());
                 }
             }
 
@@ -619,11 +650,113 @@ bool GameEngine::executeCommand(Command& command)
     return false;
 }
 
-string GameEngine::stringToLog()
+bool GameEngine::playTournamentGame(const Map& tournamentMap, const vector<string>& strategies, int maxTurns, string& winningStrategy)
+{
+    vector<Player*> roundPlayers;
+    vector<PlayerStrategy*> roundStrategies;
+
+    // Assign player strategy
+    for (const string& strategy : strategies)
+    {
+        Player* player = new Player();
+        PlayerStrategy* playerStrategy = createPlayerStrategy(strategy, *player);
+        player->setPlayerStrategy(*playerStrategy);
+        player->setName(StringUtils::strategyToString(*playerStrategy));
+
+        roundPlayers.push_back(player);
+        roundStrategies.push_back(playerStrategy);
+    }
+
+    // Copy map, set players, initial setup
+    bool success = start(tournamentMap, roundPlayers);
+    if (success)
+    {
+        winningStrategy = "Draw";
+
+        // Run until we have a draw at maxTurns or a winner
+        for (int turn = 0; turn < maxTurns && alivePlayers.size() > 1; ++turn)
+        {
+            executeTurn();
+        }
+
+        // Determine winner
+        if (alivePlayers.size() == 1)
+        {
+            winningStrategy = StringUtils::strategyToString(alivePlayers.front()->getPlayerStrategy());
+        }
+    }
+
+    // Reset state
+    state = State::Start;
+
+    for (Player* player : roundPlayers)
+    {
+        delete player;
+    }
+    for (PlayerStrategy* strategy : roundStrategies)
+    {
+        delete strategy;
+    }
+
+    return success;
+}
+
+PlayerStrategy* GameEngine::createPlayerStrategy(const string& strategy, Player& player)
+{
+    if (strategy == "aggressive")
+    {
+        return new AggressivePlayerStrategy(player);
+    }
+    else if (strategy == "benevolent")
+    {
+        return new BenevolentPlayerStrategy(player);
+    }
+    else if (strategy == "neutral")
+    {
+        return new NeutralPlayerStrategy(player);
+    }
+    else if (strategy == "cheater")
+    {
+        return new CheaterPlayerStrategy(player);
+    }
+    else
+    {
+        return nullptr;
+    }
+}
+
+std::ostream& GameEngine::printEvent(std::ostream& out, Event event, State state, const std::string& playerName, Card::Type card)
+{
+    switch (event)
+    {
+        case Event::StateChanged:
+        {
+            out << "GameEngine: State has been changed to '" << state << "'";
+            break;
+        }
+        case Event::PlayerEliminated:
+        {
+            out << "GameEngine: " << playerName << " has been eliminated";
+            break;
+        }
+        case Event::CardDrawn:
+        {
+            out << "GameEngine: " << playerName << " drew a " << card << " card";
+            break;
+        }
+    }
+    return out;
+}
+
+void GameEngine::publishEvent(Event event, const Player* player, Card::Type card)
+{
+    EventBus::publish(EngineEvent{ *this, event, player, card });
+}
+
+std::ostream& EngineEvent::print(std::ostream& out) const
 {
-    std::ostringstream stream;
-    stream << "GameEngine: State has been changed to '" << state << "'";
-    return stream.str();
+    static const std::string noName;
+    return GameEngine::printEvent(out, event, engine.getState(), player == nullptr ? noName : player->getName(), card);
 }
 
 // Runs the game until only one player is left
@@ -648,11 +781,13 @@ void GameEngine::executeTurn()
     // Give players who conquered a territory last turn a card
     for (Player* player : alivePlayers)
     {
-        bool hasMaxCardsInHand = player->getCards()->getCards().size() >= 6;
+        bool hasMaxCardsInHand = player->getCards()->isFull();
         if (player->hasConqueredThisTurn && !hasMaxCardsInHand)
         {
             player->hasConqueredThisTurn = false;
-            player->getCards()->addCard(*mainDeck.draw());
+            Card& card = *context.getDeck().draw(context.getRandom());
+            player->getCards()->addCard(card);
+            publishEvent(Event::CardDrawn, player, card.getType());
         }
     }
 
@@ -666,7 +801,7 @@ void GameEngine::executeTurn()
     eliminatePlayers();
 
     // Increment turn counter
-    turnIndex++;
+    context.nextTurn();
 }
 
 // Give players armies based on territories owns and bonus from continent
@@ -680,15 +815,10 @@ void GameEngine::reinforcementPhase()
         int armiesToAdd = static_cast<int>(player->getTerritories().size()) / 3;
 
         // Check if player controls continents
-        vector<int> numTerritoriesPerContinent(map->continents.size());
-        for (auto territory : player->getTerritories())
-        {
-            numTerritoriesPerContinent[territory->continentID - 1]++;
-        }
         for (auto continent : map->continents)
         {
             // If player controls continent add bonus
-            if (continent->territories.size() == numTerritoriesPerContinent[continent->ID - 1])
+            if (player->controlsContinent(*continent))
             {
                 armiesToAdd += continent->bonus;
             }
@@ -707,17 +837,71 @@ void GameEngine::issueOrdersPhase()
 {
     this->transition(GameEngine::State::IssueOrders);
 
-    // Determines when to stop issuing orders
-    while (true)
+    // Players issue roughly one order per owned territory, make room for them upfront
+    // Their strategies plan the turn once here, and keep the plan up to date as they issue orders
+    for (Player* player : alivePlayers)
     {
-        int skipCount = 0;
+        player->getOrders()->reserve(player->getTerritories().size());
+        player->planTurn(*this);
+    }
 
-        for (Player* player : alivePlayers)
+    // Deploy orders change armies as soon as they are issued, so players issue all their orders for the turn at once
+    // only if none of them looks at what the others issued before them: otherwise they are all asked one by one
+    bool issuingAtOnce = all_of(alivePlayers.begin(), alivePlayers.end(), [](Player* player)
+    {
+        return player->canIssueOrdersAtOnce();
+    });
+    turnOrders.resize(alivePlayers.size());
+    for (size_t i = 0; i < alivePlayers.size(); ++i)
+    {
+        turnOrders[i].clear();
+        if (issuingAtOnce)
         {
-            Order* currOrder = player->issueOrder(*this);
-            if (currOrder == nullptr)
+            alivePlayers[i]->issueOrders(*this, turnOrders[i]);
+        }
+    }
+
+    // Every player issues orders until it has no more
+    doneIssuing.assign(alivePlayers.size(), false);
+    issuingPlayers.clear();
+    for (size_t i = 0; i < alivePlayers.size(); ++i)
+    {
+        issuingPlayers.push_back(i);
+    }
+
+    // Orders are queued one per player at a time (round-robin), asking the other players for theirs as their turn comes
+    // Players who are done are left out of the next rounds, so each round only visits the players still issuing orders
+    for (size_t round = 0; !issuingPlayers.empty(); ++round)
+    {
+        size_t skipCount = 0;
+
+        for (size_t i : issuingPlayers)
+        {
+            Player* player = alivePlayers[i];
+            const OrderSink& batch = turnOrders[i];
+
+            // After a batch that ends with a pass, the player is asked for its next orders as their turn comes
+            bool askPlayer = !issuingAtOnce || (batch.hasPassed() && round > batch.size());
+            OrderData currOrder;
+            if (askPlayer)
             {
+                currOrder = player->issueOrder(*this);
+            }
+            else if (round < batch.size())
+            {
+                currOrder = batch.at(round);
+            }
+
+            if (currOrder.empty())
+            {
+                // A player can also pass a round, and have more orders in the next one
                 skipCount++;
+                doneIssuing[i] = askPlayer ? player->isDoneIssuing() : !batch.hasPassed();
+            }
+            else if (!askPlayer)
+            {
+                // Described as it was when issued, as if the player had been asked for it in this round
+                player->getOrders()->addOrder(currOrder, batch.effectAt(round));
             }
             else
             {
@@ -725,11 +909,17 @@ void GameEngine::issueOrdersPhase()
             }
         }
 
-        // All players signaled they have no more orders to issue
-        if (skipCount == alivePlayers.size())
+        // All players still issuing orders passed this round, the others are done: the phase is over
+        if (skipCount == issuingPlayers.size())
         {
             break;
         }
+
+        // Players who signaled they have no more orders to issue are done for the turn, the others keep their turn order
+        issuingPlayers.erase(remove_if(issuingPlayers.begin(), issuingPlayers.end(), [&](size_t i)
+        {
+            return doneIssuing[i];
+        }), issuingPlayers.end());
     }
 }
 
@@ -746,20 +936,16 @@ void GameEngine::executeOrdersPhase()
         for (Player* player : alivePlayers)
         {
             OrdersList* ordersList = player->getOrders();
-            vector<Order*>& orders = ordersList->getOrdersList();
 
-            if (orders.size() == 0)
+            if (ordersList->empty())
             {
                 skipCount++;
             }
             else
             {
-                Order* order = orders.front();
-
-                if (order->getType() == Order::Type::Deploy)
+                if (ordersList->front().type == Order::Type::Deploy)
                 {
-                    order->execute();
-                    ordersList->remove(0);
+                    ordersList->executeFront(context);
                 }
                 else
                 {
@@ -783,17 +969,14 @@ void GameEngine::executeOrdersPhase()
         for (Player* player : alivePlayers)
         {
             OrdersList* ordersList = player->getOrders();
-            vector<Order*>& orders = ordersList->getOrdersList();
 
-            if (orders.size() == 0)
+            if (ordersList->empty())
             {
                 skipCount++;
             }
             else
             {
-                Order* order = orders.front();
-                order->execute();
-                ordersList->remove(0);
+                ordersList->executeFront(context);
             }
         }
 
@@ -822,13 +1005,14 @@ void GameEngine::eliminatePlayers()
         {
             eliminatedPlayers.push_back(player);
             i = alivePlayers.erase(i);
+            publishEvent(Event::PlayerEliminated, player);
         }
     }
 }
 
 int GameEngine::getTurnIndex() const
 {
-    return turnIndex;
+    return context.getTurnIndex();
 }
 
 
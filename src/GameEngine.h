@@ -1,5 +1,7 @@
 #pragma once
-#include "LoggingObserver.h"
+#include "EventBus.h"
+#include "GameContext.h"
+#include "Orders.h"
 #include <ostream>
 #include <string>
 #include <vector>
@@ -10,10 +12,11 @@ using namespace std;
 class Command;
 class Map;
 class Player;
+class PlayerStrategy;
 class StateInfo;
 
 // Runs the game logic
-class GameEngine : public Subject, public ILoggable
+class GameEngine
 {
 public :
 
@@ -56,6 +59,17 @@ public :
     // Stream output operator of Transition
     friend std::ostream& operator << (std::ostream& out, const Transition source);
 
+    // Events that the engine publishes, besides those of its commands and orders
+    enum class Event
+    {
+        StateChanged,
+        PlayerEliminated,
+        CardDrawn
+    };
+
+    // Prints an event as it is logged (the player and card are only used by the events about them)
+    static std::ostream& printEvent(std::ostream& out, Event event, State state, const std::string& playerName, Card::Type card);
+
     // Default constructor
     GameEngine();
     // Copy constructor
@@ -100,9 +114,16 @@ public :
     // Returns the neutral player
     Player& getNeutralPlayer();
 
+    // Returns the per-game state (deck, random number generator, neutral player, turn counter)
+    GameContext& getContext();
+
     // Performs initial setup with given map and players
     bool start(string mapFilepath, vector<Player*>& players);
 
+    // Performs initial setup with given players, on a copy of a map that is already loaded and validated.
+    // Successive games on copies of the same map reuse the engine's map instead of reallocating it.
+    bool start(const Map& loadedMap, vector<Player*>& players);
+
     // Executes a command. Returns a success status.
     bool executeCommand(Command& command);
 
@@ -112,9 +133,6 @@ public :
     // Executes a single turn of the game
     void executeTurn();
 
-    // Implementation of stringToLog function inherited from ILoggable
-    string stringToLog();
-
     // Incremented every turn
     // Doesn't get reset between games
     int getTurnIndex() const;
@@ -124,6 +142,16 @@ private:
     // Call before starting a new game
     void cleanup(bool prepareNewGame);
 
+    // Clears the players and resets the per-game state, leaving the map untouched
+    void resetGameState();
+
+    // Plays a single tournament game on a copy of the given map, with one player per strategy.
+    // Stores the winning strategy name (or "Draw") in winningStrategy. Returns false if the game couldn't start.
+    bool playTournamentGame(const Map& tournamentMap, const vector<string>& strategies, int maxTurns, string& winningStrategy);
+
+    // Creates the strategy matching a lower-case strategy name (nullptr if unknown)
+    static PlayerStrategy* createPlayerStrategy(const string& strategy, Player& player);
+
     // Calculates Reinforcements for players
     void reinforcementPhase();
 
@@ -136,6 +164,9 @@ private:
     // Verifies if a player need to be eliminated
     void eliminatePlayers();
 
+    // Publishes an event of the engine
+    void publishEvent(Event event, const Player* player = nullptr, Card::Type card = Card::Type::Bomb);
+
     // Holds the current state
     State state;
 
@@ -151,12 +182,33 @@ private:
     // Holds eliminated players
     vector<Player*> eliminatedPlayers;
 
-    // Neutral player
-    Player* neutralPlayer;
+    // Holds the deck, random number generator, neutral player and turn counter of the game
+    GameContext context;
 
-    // Incremented every turn
-    // Doesn't get reset between games
-    int turnIndex;
+    // Orders issued at once by each alive player during the issue orders phase, kept from one turn to the next
+    vector<OrderSink> turnOrders;
+
+    // Per alive player: whether it has no more orders to issue this turn
+    vector<bool> doneIssuing;
+
+    // Alive players (indices in alivePlayers) who still issue orders this turn, in turn order
+    vector<size_t> issuingPlayers;
+};
+
+// Event published by a game engine
+struct EngineEvent
+{
+    // The engine, in the state the event left it in
+    GameEngine& engine;
+    // What happened
+    GameEngine::Event event;
+    // Player the event is about (nullptr for state changes)
+    const Player* player;
+    // Card that was drawn
+    Card::Type card;
+
+    // Prints the event as it is logged
+    std::ostream& print(std::ostream& out) const;
 };
 
 // Describes a State's graph connectivity
@@ -0,0 +1,94 @@
+#include "EventLog.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+// Prints how to use the program
+static void printUsage(const char* program)
+{
+    std::cerr << "Usage: " << program << " <event log> [-g game] [-p player name] [-t turn]" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    // Filters, a negative number or empty name matches everything
+    long game = -1;
+    long turn = -1;
+    std::string playerName;
+
+    for (int i = 2; i < argc; ++i)
+    {
+        if (i + 1 >= argc)
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+
+        if (std::strcmp(argv[i], "-g") == 0)
+        {
+            game = std::strtol(argv[++i], nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "-t") == 0)
+        {
+            turn = std::strtol(argv[++i], nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "-p") == 0)
+        {
+            playerName = argv[++i];
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    EventLogReader reader;
+    if (!reader.open(argv[1]))
+    {
+        std::cerr << "Can't read event log " << argv[1] << std::endl;
+        return 1;
+    }
+
+    // Render the records that match the filters, in the order they were logged
+    EventRecord record;
+    std::string text;
+    while (reader.next(record, text))
+    {
+        if (text.empty())
+        {
+            continue;
+        }
+        if (game >= 0 && record.game != static_cast<unsigned long>(game))
+        {
+            continue;
+        }
+        if (turn >= 0 && record.turn != turn)
+        {
+            continue;
+        }
+        if (!playerName.empty() && reader.getPlayerName(record.game, record.player) != playerName && reader.getPlayerName(record.game, record.targetPlayer) != playerName)
+        {
+            continue;
+        }
+
+        std::cout << text << '\n';
+    }
+
+    if (reader.isCorrupt())
+    {
+        std::cout.flush();
+        std::cerr << "Event log " << argv[1] << " is corrupt, stopped reading at an invalid record" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
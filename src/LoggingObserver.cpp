@@ -1,126 +1,327 @@
 #include "LoggingObserver.h"
+#include "CommandProcessing.h"
+#include "GameEngine.h"
+#include "Orders.h"
 
 #include <algorithm>
+#include <csignal>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
 #include <iostream>
 #include <fstream>
+#include <list>
+#include <sstream>
 
-/* --- Subject --- */
+/* --- LogRingBuffer --- */
 
-// Constructor for Subject which initializes an empty Observer* list
-Subject::Subject()
+// LogRingBuffer constructor
+LogRingBuffer::LogRingBuffer(size_t capacity):
+    slots(nullptr),
+    mask(0),
+    pushPosition(0),
+    popPosition(0)
 {
-    list<Observer*> temp;
-    observers = temp;
+    size_t size = 2;
+    while (size < capacity)
+    {
+        size *= 2;
+    }
+
+    slots = new Slot[size];
+    mask = size - 1;
+
+    // Slot i is free for the push at position i
+    for (size_t i = 0; i < size; ++i)
+    {
+        slots[i].sequence.store(i, memory_order_relaxed);
+    }
 }
 
-// Copy constructor for Subject
-Subject::Subject(const Subject& other):
-    observers(other.observers)
+// Copy constructor for LogRingBuffer (the lines aren't copied)
+LogRingBuffer::LogRingBuffer(const LogRingBuffer& other):
+    LogRingBuffer(other.capacity())
 {
 
 }
 
 // Stream insertion operator
-ostream& operator << (ostream& out, const Subject& source)
+ostream& operator << (ostream& out, const LogRingBuffer& source)
 {
-    // Printing out the size of the observers list
-    out << "#Observers: " << source.observers.size();
+    out << "LogRingBuffer lines: " << source.size() << "/" << source.capacity();
     return out;
 }
 
-// Assignment operator
-Subject& Subject::operator = (const Subject& other)
+// Assignment operator (the lines aren't copied)
+LogRingBuffer& LogRingBuffer::operator = (const LogRingBuffer& other)
 {
-    // Shallow copy the Observer pointers
-    this->observers = other.observers;
     return *this;
 }
 
-// Destructor for the Subject
-Subject::~Subject()
+// LogRingBuffer destructor
+LogRingBuffer::~LogRingBuffer()
+{
+    delete[] slots;
+}
+
+// Moves a line into the buffer, swapping it with an empty one. Returns false if the buffer is full.
+bool LogRingBuffer::tryPush(string& line)
 {
+    size_t position = pushPosition.load(memory_order_relaxed);
+    Slot* slot = nullptr;
+
+    while (true)
+    {
+        slot = &slots[position & mask];
+        size_t sequence = slot->sequence.load(memory_order_acquire);
+
+        if (sequence == position)
+        {
+            // The slot is free, claim it unless another producer did first
+            if (pushPosition.compare_exchange_weak(position, position + 1, memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (sequence < position)
+        {
+            // The slot still holds the line pushed one lap earlier
+            return false;
+        }
+        else
+        {
+            // Another producer claimed the slot, try the next position
+            position = pushPosition.load(memory_order_relaxed);
+        }
+    }
 
+    slot->line.swap(line);
+    line.clear();
+    slot->sequence.store(position + 1, memory_order_release);
+    return true;
 }
 
-// Attaches an observer to the subject
-void Subject::attach(Observer& o)
+// Moves the oldest line out of the buffer (single consumer only). Returns false if the buffer is empty.
+bool LogRingBuffer::tryPop(string& line)
 {
-    bool found = find(observers.begin(), observers.end(), &o) != observers.end();
-    if (!found)
+    size_t position = popPosition.load(memory_order_relaxed);
+    Slot& slot = slots[position & mask];
+
+    if (slot.sequence.load(memory_order_acquire) != position + 1)
     {
-        observers.push_back(&o);
+        return false;
     }
+
+    line.swap(slot.line);
+    // The slot is now free for the push one lap later
+    slot.sequence.store(position + mask + 1, memory_order_release);
+    popPosition.store(position + 1, memory_order_relaxed);
+    return true;
 }
 
-// Dettaches an observer from the subject
-void Subject::detach(Observer& o)
+// Approximate number of lines in the buffer
+size_t LogRingBuffer::size() const
 {
-    observers.remove(&o);
+    size_t pushed = pushPosition.load(memory_order_relaxed);
+    size_t popped = popPosition.load(memory_order_relaxed);
+    return pushed > popped ? pushed - popped : 0;
 }
 
-// Notifies (calls "update" on) all the attached observers
-void Subject::notify()
+// Maximum number of lines in the buffer
+size_t LogRingBuffer::capacity() const
 {
-    for(Observer* observer: observers) {
-        observer->update(*this);
+    return mask + 1;
+}
+
+// Writes the lines in the buffer, oldest first, with nothing but atomic loads and write()
+void LogRingBuffer::writeTo(int fileDescriptor) const
+{
+    size_t end = pushPosition.load(memory_order_acquire);
+    for (size_t position = popPosition.load(memory_order_acquire); position != end; ++position)
+    {
+        const Slot& slot = slots[position & mask];
+        if (slot.sequence.load(memory_order_acquire) != position + 1)
+        {
+            // Still being pushed
+            return;
+        }
+
+        const char* bytes = slot.line.data();
+        size_t remaining = slot.line.size();
+        while (remaining > 0)
+        {
+            ssize_t written = write(fileDescriptor, bytes, remaining);
+            if (written <= 0)
+            {
+                return;
+            }
+            bytes += written;
+            remaining -= written;
+        }
     }
 }
 
-/* --- Observer --- */
+/* --- LogObserver --- */
+
+// Signals after which the writer threads write their queued lines, then raise the signal again
+static const int terminationSignals[] = { SIGHUP, SIGINT, SIGPIPE, SIGTERM };
+// Signals on which the process can't go on, the signal handler writes the queued lines itself
+static const int crashSignals[] = { SIGABRT, SIGBUS, SIGFPE, SIGSEGV };
 
-// Constructor for Observer
-Observer::Observer()
-{
+// Handlers of the signals before the first LogObserver started, in the order above
+static struct sigaction previousTerminationActions[sizeof(terminationSignals) / sizeof(int)];
+static struct sigaction previousCrashActions[sizeof(crashSignals) / sizeof(int)];
 
-}
+// Signal received while LogObservers were running, 0 if none
+static volatile sig_atomic_t pendingSignal = 0;
 
-// Copy constructor for Observer
-Observer::Observer(const Observer& other)
-{
+// Number of LogObservers whose writer thread is running, readable from signal handlers
+static atomic<int> runningObserverCount(0);
 
+// LogObservers whose writer thread is running
+static mutex runningObserversMutex;
+static list<LogObserver*> runningObservers;
+
+// The same LogObservers, for the crash signal handler which can't lock the mutex (only the first ones fit)
+static const size_t maxCrashObservers = 16;
+static atomic<LogObserver*> crashObservers[maxCrashObservers];
+
+// Gives a termination signal its previous handler back, and raises it again
+static void raiseTerminationSignal(int signal)
+{
+    for (size_t i = 0; i < sizeof(terminationSignals) / sizeof(int); ++i)
+    {
+        if (terminationSignals[i] == signal)
+        {
+            sigaction(signal, &previousTerminationActions[i], nullptr);
+        }
+    }
+    raise(signal);
 }
 
-// Stream insertion operator
-ostream& operator << (ostream& out, const Observer& source)
+// Remembers the signal, so that writer threads write their queued lines before raising it again
+static void onTerminationSignal(int signal)
 {
-    // The Observor doesn't really have any properties we can print out, so we just print out that it's an Observor
-    out << "Observer";
-    return out;
+    if (runningObserverCount.load() == 0)
+    {
+        // No writer thread to raise it again
+        raiseTerminationSignal(signal);
+        return;
+    }
+    pendingSignal = signal;
 }
 
-// Assignment operator
-Observer& Observer::operator = (const Observer& other)
+// Replaces the handlers of the termination and crash signals, remembering the previous ones
+// A signal that was ignored stays ignored
+static void installSignalHandlers(void (*crashHandler)(int))
 {
-    return *this;
+    struct sigaction action;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = 0;
+
+    for (size_t i = 0; i < sizeof(terminationSignals) / sizeof(int); ++i)
+    {
+        sigaction(terminationSignals[i], nullptr, &previousTerminationActions[i]);
+        if (previousTerminationActions[i].sa_handler != SIG_IGN)
+        {
+            action.sa_handler = onTerminationSignal;
+            sigaction(terminationSignals[i], &action, nullptr);
+        }
+    }
+
+    for (size_t i = 0; i < sizeof(crashSignals) / sizeof(int); ++i)
+    {
+        sigaction(crashSignals[i], nullptr, &previousCrashActions[i]);
+        if (previousCrashActions[i].sa_handler != SIG_IGN)
+        {
+            action.sa_handler = crashHandler;
+            sigaction(crashSignals[i], &action, nullptr);
+        }
+    }
 }
 
-// Destructor for Observer
-Observer::~Observer()
+// Puts back the handlers the signals had before installSignalHandlers
+static void restoreSignalHandlers()
 {
+    for (size_t i = 0; i < sizeof(terminationSignals) / sizeof(int); ++i)
+    {
+        sigaction(terminationSignals[i], &previousTerminationActions[i], nullptr);
+    }
 
+    for (size_t i = 0; i < sizeof(crashSignals) / sizeof(int); ++i)
+    {
+        sigaction(crashSignals[i], &previousCrashActions[i], nullptr);
+    }
 }
 
-/* --- LogObserver --- */
+// Writes the lines queued by running LogObservers when the process exits without destroying them
+static void flushRunningObservers()
+{
+    lock_guard<mutex> lock(runningObserversMutex);
+    for (LogObserver* observer : runningObservers)
+    {
+        observer->flush();
+    }
+}
+
+const std::chrono::milliseconds LogObserver::defaultFlushInterval(100);
 
 // LogObserver constructor
 LogObserver::LogObserver():
-    filepath("gamelog.txt")
+    LogObserver("gamelog.txt")
 {
-    filestream.open(filepath);
+
 }
 
 // LogObserver parametrized constructor
 LogObserver::LogObserver(const std::string& filepath):
-    filepath(filepath)
+    LogObserver(filepath, defaultFlushInterval, defaultCapacity)
 {
-    filestream.open(filepath);
+
 }
 
-// Copy constructor for Observer
+// LogObserver parametrized constructor
+LogObserver::LogObserver(const std::string& filepath, std::chrono::milliseconds flushInterval, size_t capacity):
+    filepath(filepath),
+    mode(ios_base::out),
+    flushInterval(flushInterval),
+    queue(capacity),
+    wakeRequested(false),
+    stopRequested(false),
+    queuedCount(0),
+    writtenCount(0),
+    crashFileDescriptor(-1)
+{
+    start();
+}
+
+// LogObserver parametrized constructor
+LogObserver::LogObserver(const std::string& filepath, ios_base::openmode mode):
+    filepath(filepath),
+    mode(mode),
+    flushInterval(defaultFlushInterval),
+    queue(defaultCapacity),
+    wakeRequested(false),
+    stopRequested(false),
+    queuedCount(0),
+    writtenCount(0),
+    crashFileDescriptor(-1)
+{
+    start();
+}
+
+// Copy constructor for LogObserver
 LogObserver::LogObserver(const LogObserver& other):
-    filepath(other.filepath)
+    filepath(other.filepath),
+    mode(other.mode),
+    flushInterval(other.flushInterval),
+    queue(other.queue.capacity()),
+    wakeRequested(false),
+    stopRequested(false),
+    queuedCount(0),
+    writtenCount(0)
 {
-    filestream.open(filepath);
+    start();
 }
 
 // Stream insertion operator
@@ -134,14 +335,13 @@ ostream& operator << (ostream& out, const LogObserver& source)
 // Assignment operator
 LogObserver& LogObserver::operator = (const LogObserver& other)
 {
-    // Close old opened file
-    if (isOpen())
-    {
-        filestream.close();
-    }
+    // Finish writing to the old file
+    stop();
 
     filepath = other.filepath;
-    filestream.open(filepath);
+    mode = other.mode;
+    flushInterval = other.flushInterval;
+    start();
 
     return *this;
 }
@@ -149,28 +349,71 @@ LogObserver& LogObserver::operator = (const LogObserver& other)
 // LogObserver destructor
 LogObserver::~LogObserver()
 {
-    // filestream closes file automatically in its destructor, no need to call explicitly
+    unsubscribe();
+    // Write the remaining lines before the file closes
+    stop();
+}
+
+// Subscribes to the events that are logged
+void LogObserver::subscribe()
+{
+    EventBus::subscribe<CommandEvent>(*this);
+    EventBus::subscribe<EngineEvent>(*this);
+    EventBus::subscribe<OrderEvent>(*this);
 }
 
+// Unsubscribes from the events that are logged
+void LogObserver::unsubscribe()
+{
+    EventBus::unsubscribe<CommandEvent>(this);
+    EventBus::unsubscribe<EngineEvent>(this);
+    EventBus::unsubscribe<OrderEvent>(this);
+}
+
+// Writes a command event as a line of text
+void LogObserver::update(const CommandEvent& event)
+{
+    ostringstream stream;
+    event.print(stream) << '\n';
+    string line = stream.str();
+    enqueue(line);
+}
 
-// LogObserver update function inherited from the Observer class and overriden
-// log parameter must implement ILoggable 
-void LogObserver::update(Subject& log)
+// Writes a game engine event as a line of text
+void LogObserver::update(const EngineEvent& event)
 {
-    // The stringToLog function is only available for classes that inherit ILoggable, so we use dynamic_cast
-    ILoggable* loggable = dynamic_cast<ILoggable*>(&log);
+    ostringstream stream;
+    event.print(stream) << '\n';
+    string line = stream.str();
+    enqueue(line);
+}
 
-    // Write to file
-    filestream << loggable->stringToLog() << endl;
-    filestream.flush();
+// Writes an order event as a line of text
+void LogObserver::update(const OrderEvent& event)
+{
+    ostringstream stream;
+    event.print(stream) << '\n';
+    string line = stream.str();
+    enqueue(line);
 }
 
 // Writes a line to the file
 void LogObserver::appendLine(const char* line)
 {
-    // Write to file
-    filestream << line << endl;
-    filestream.flush();
+    string copy(line);
+    copy += '\n';
+    enqueue(copy);
+}
+
+// Waits until every line queued so far is written to the file
+void LogObserver::flush()
+{
+    size_t target = queuedCount.load();
+
+    unique_lock<mutex> lock(writerMutex);
+    wakeRequested = true;
+    writerWakeUp.notify_one();
+    linesWritten.wait(lock, [&] { return writtenCount >= target; });
 }
 
 // Returns status of log file
@@ -179,30 +422,166 @@ bool LogObserver::isOpen() const
     return filestream.is_open();
 }
 
-/* --- ILoggable --- */
+// Queues bytes for the writer thread, waiting for room if the queue is full
+void LogObserver::enqueue(string& bytes)
+{
+    while (!queue.tryPush(bytes))
+    {
+        wakeWriter();
+        this_thread::yield();
+    }
+    queuedCount++;
+
+    // Don't wait for the flush interval to empty a queue that is filling up
+    if (queue.size() == queue.capacity() / 2)
+    {
+        wakeWriter();
+    }
+}
+
+// Wakes the writer thread up before its flush interval is over
+void LogObserver::wakeWriter()
+{
+    lock_guard<mutex> lock(writerMutex);
+    wakeRequested = true;
+    writerWakeUp.notify_one();
+}
+
+// Opens the file and starts the writer thread
+void LogObserver::start()
+{
+    // A call to exit must not lose the queued lines
+    static once_flag registerExitHandler;
+    call_once(registerExitHandler, []
+    {
+        atexit(flushRunningObservers);
+    });
+
+    filestream.open(filepath, mode);
+    crashFileDescriptor = filestream.is_open() ? open(filepath.c_str(), O_WRONLY | O_APPEND) : -1;
+    stopRequested = false;
+    writer = thread(&LogObserver::writerLoop, this);
+
+    lock_guard<mutex> lock(runningObserversMutex);
+    runningObservers.push_back(this);
+    for (atomic<LogObserver*>& crashObserver : crashObservers)
+    {
+        LogObserver* none = nullptr;
+        if (crashObserver.compare_exchange_strong(none, this))
+        {
+            break;
+        }
+    }
+
+    // Nor must signals, while an observer runs
+    if (runningObserverCount++ == 0)
+    {
+        installSignalHandlers(onCrashSignal);
+    }
+}
 
-// ILoggable default constructor
-ILoggable::ILoggable()
+// Stops the writer thread once every queued line is written, and closes the file
+void LogObserver::stop()
 {
+    {
+        lock_guard<mutex> lock(runningObserversMutex);
+        runningObservers.remove(this);
+        for (atomic<LogObserver*>& crashObserver : crashObservers)
+        {
+            LogObserver* self = this;
+            crashObserver.compare_exchange_strong(self, nullptr);
+        }
+
+        if (--runningObserverCount == 0)
+        {
+            restoreSignalHandlers();
+        }
+    }
+
+    {
+        lock_guard<mutex> lock(writerMutex);
+        stopRequested = true;
+        writerWakeUp.notify_one();
+    }
+
+    if (writer.joinable())
+    {
+        writer.join();
+    }
 
+    // filestream would close file automatically in its destructor, but may be reopened
+    filestream.close();
+    if (crashFileDescriptor != -1)
+    {
+        close(crashFileDescriptor);
+        crashFileDescriptor = -1;
+    }
 }
 
-// Copy constructor for ILoggable
-ILoggable::ILoggable(const ILoggable& other)
+// Body of the writer thread
+void LogObserver::writerLoop()
 {
+    unique_lock<mutex> lock(writerMutex);
+    while (!stopRequested)
+    {
+        writerWakeUp.wait_for(lock, flushInterval, [&] { return wakeRequested || stopRequested; });
+        wakeRequested = false;
+
+        lock.unlock();
+        writeQueuedLines();
+
+        // A termination signal was received, let it terminate the process now that the lines are written
+        int signalReceived = pendingSignal;
+        if (signalReceived != 0)
+        {
+            pendingSignal = 0;
+            raiseTerminationSignal(signalReceived);
+        }
+        lock.lock();
+    }
 
+    // Producers have stopped by now, whatever is left is the last batch
+    lock.unlock();
+    writeQueuedLines();
 }
 
-// Stream insertion operator
-ostream& operator << (ostream& out, const ILoggable& source)
+// Writes every queued line to the file, in a single write
+void LogObserver::writeQueuedLines()
 {
-    // ILoggable doesn't really have any properties we can print out, so we just print out that it's an ILoggable
-    out << "ILoggable";
-    return out;
+    size_t count = 0;
+    string bytes;
+
+    batch.clear();
+    while (queue.tryPop(bytes))
+    {
+        batch += bytes;
+        count++;
+    }
+
+    if (count > 0)
+    {
+        filestream.write(batch.data(), batch.size());
+        filestream.flush();
+    }
+
+    // Let flush know how far the file is written
+    lock_guard<mutex> lock(writerMutex);
+    writtenCount += count;
+    linesWritten.notify_all();
 }
 
-// Assignment operator
-ILoggable& ILoggable::operator = (const ILoggable& other)
+// Last chance for the queued lines: write them without locking or allocating, then let the signal end the process
+void LogObserver::onCrashSignal(int signal)
 {
-    return *this;
+    for (const atomic<LogObserver*>& crashObserver : crashObservers)
+    {
+        LogObserver* observer = crashObserver.load();
+        if (observer != nullptr && observer->crashFileDescriptor != -1)
+        {
+            observer->queue.writeTo(observer->crashFileDescriptor);
+        }
+    }
+
+    ::signal(signal, SIG_DFL);
+    raise(signal);
 }
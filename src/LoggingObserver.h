@@ -1,97 +1,145 @@
 #pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
 #include <iostream>
 #include <fstream>
-#include <list>
+#include <mutex>
 #include <string>
+#include <thread>
 using namespace std;
 
-// Forward declaration so that Observer can use Subject
-class Subject;
+// Forward declarations of the events that are logged
+struct CommandEvent;
+struct EngineEvent;
+struct OrderEvent;
 
-// ILoggable abstract class which requires the inheriting class to implement a stringToLog function
-class ILoggable {
+// Bounded queue of log lines, that any number of threads can push to and a single thread pops from, without locks.
+// Each slot carries a sequence number telling whether it is free for the next push or holds the next line to pop.
+// Popped slots keep the popping thread's old line buffer, so that lines reuse memory instead of allocating.
+class LogRingBuffer {
     public:
-        // Default constructor
-        ILoggable();
-        // Stream output operator of ILoggable
-        friend std::ostream& operator << (std::ostream& out, const ILoggable& source);
-        // String to log function whose implementation specifies what is logged to the "gamelog.txt" file
-        virtual string stringToLog() = 0;
+        // LogRingBuffer constructor, the capacity is rounded up to a power of 2
+        LogRingBuffer(size_t capacity);
+        // LogRingBuffer destructor
+        ~LogRingBuffer();
+        // Stream output operator of LogRingBuffer
+        friend std::ostream& operator << (std::ostream& out, const LogRingBuffer& source);
+        // Moves a line into the buffer, swapping it with an empty one. Returns false if the buffer is full.
+        bool tryPush(string& line);
+        // Moves the oldest line out of the buffer (single consumer only). Returns false if the buffer is empty.
+        bool tryPop(string& line);
+        // Approximate number of lines in the buffer
+        size_t size() const;
+        // Maximum number of lines in the buffer
+        size_t capacity() const;
+        // Writes the lines in the buffer to a file descriptor without popping them, only calling write(),
+        // so that a signal handler can use it while the process crashes
+        void writeTo(int fileDescriptor) const;
 
     private:
-        // Observer copy constructor
-        ILoggable(const ILoggable& other);
-        // Assignment operator of ILoggable
-        ILoggable& operator = (const ILoggable& other);
+        // LogRingBuffer copy constructor
+        LogRingBuffer(const LogRingBuffer& other);
+        // Assignment operator of LogRingBuffer
+        LogRingBuffer& operator = (const LogRingBuffer& other);
 
-};
-
-class Observer {
-    public:
-        // Observer constructor
-        Observer();
-        // Observer destructor
-        virtual ~Observer();
-         // Stream output operator of Observer
-        friend std::ostream& operator << (std::ostream& out, const Observer& source);
-        // Update method which signifies an update to the state was received and we will act on it (be it updating a view or in this case, writing to a file)
-        virtual void update(Subject& subject) = 0;
-
-    private:
-        // Observer copy constructor
-        Observer(const Observer& other);
-        // Assignment operator of Observer
-        Observer& operator = (const Observer& other);
-};
+        // A slot of the buffer
+        struct Slot {
+            atomic<size_t> sequence;
+            string line;
+        };
 
-// Subject class which represents the Subject that will be observed
-class Subject {
-    public:
-        // Subject constructor
-        Subject();
-        // Subject copy constructor
-        Subject(const Subject& other);
-        // Subject destructor
-        ~Subject();
-        // Assignment operatorof Subject
-        Subject& operator = (const Subject& other);
-        // Stream output operator of Subject
-        friend std::ostream& operator << (std::ostream& out, const Subject& source);
-        // Attach method which adds an Observer to "observers"
-        virtual void attach(Observer& observer);
-        // Detach method which removes an Observer from "observers"
-        virtual void detach(Observer& observer);
-        // Method which calls the "update" method for each Observer in "observers"
-        virtual void notify();
-       
-    protected:
-        list<Observer*> observers;
+        Slot* slots;
+        size_t mask;
+        // Position of the next push, shared by the producers
+        atomic<size_t> pushPosition;
+        // Position of the next pop, only changed by the consumer
+        atomic<size_t> popPosition;
 };
 
-// LogObserver class which is a specific type of Observer which allows for logging
-class LogObserver : public Observer {
+// LogObserver class which logs the events published to the EventBus, once subscribed to them
+// Lines are handed to a background thread, which writes them to the file in batches every flush interval,
+// or sooner when the queue fills up. Queued lines are written when the LogObserver is destroyed, when the
+// process exits, and when it receives SIGHUP, SIGINT, SIGPIPE or SIGTERM (the signal is raised again once they
+// are written). On SIGABRT, SIGBUS, SIGFPE or SIGSEGV the signal handler writes the lines still queued itself,
+// before the default action ends the process: a batch the writer thread was in the middle of writing may be lost.
+// The previous signal handlers are restored once no LogObserver is running.
+class LogObserver {
     public:
         // LogObserver constructor
         LogObserver();
         // LogObserver parametrized constructor
         LogObserver(const std::string& filepath);
+        // LogObserver parametrized constructor, with the time between writes and the maximum number of queued lines
+        LogObserver(const std::string& filepath, std::chrono::milliseconds flushInterval, size_t capacity);
         // LogObserver destructor
-        ~LogObserver();
+        virtual ~LogObserver();
         // Stream output operator of LogObserver
         friend std::ostream& operator << (std::ostream& out, const LogObserver& source);
-        // Update method implementation inherited from Observer
-        void update(Subject& subject);
+        // Subscribes to the events that are logged
+        virtual void subscribe();
+        // Unsubscribes from the events that are logged
+        virtual void unsubscribe();
+        // Update methods called by the EventBus, which write the events as lines of text
+        void update(const CommandEvent& event);
+        void update(const EngineEvent& event);
+        void update(const OrderEvent& event);
         // Writes a line to the file
         void appendLine(const char* line);
+        // Waits until every line queued so far is written to the file
+        void flush();
         // Returns status of log file
         bool isOpen() const;
 
+        // Default time between writes
+        static const std::chrono::milliseconds defaultFlushInterval;
+        // Default maximum number of queued lines
+        static const size_t defaultCapacity = 4096;
+
+    protected:
+        // LogObserver parametrized constructor, with the mode to open the file in
+        LogObserver(const std::string& filepath, ios_base::openmode mode);
+        // Queues bytes for the writer thread, waiting for room if the queue is full
+        void enqueue(string& bytes);
+
     private:
         // LogObserver copy constructor
         LogObserver(const LogObserver& other);
         // Assignment operator of LogObserver
         LogObserver& operator = (const LogObserver& other);
 
+        // Wakes the writer thread up before its flush interval is over
+        void wakeWriter();
+        // Opens the file and starts the writer thread
+        void start();
+        // Stops the writer thread once every queued line is written, and closes the file
+        void stop();
+        // Body of the writer thread
+        void writerLoop();
+        // Writes every queued line to the file, in a single write
+        void writeQueuedLines();
+        // Handler of the crash signals, writes the lines queued by the running LogObservers
+        static void onCrashSignal(int signal);
+
         string filepath;
+        ios_base::openmode mode;
+        // Only used by the writer thread while it runs
         ofstream filestream;
+        std::chrono::milliseconds flushInterval;
+        LogRingBuffer queue;
+        thread writer;
+        // Protects the writer thread's wake up and flush progress
+        mutex writerMutex;
+        condition_variable writerWakeUp;
+        condition_variable linesWritten;
+        bool wakeRequested;
+        bool stopRequested;
+        // Number of lines queued and written so far
+        atomic<size_t> queuedCount;
+        size_t writtenCount;
+        // Batch of queued bytes for the next write, kept to reuse its memory
+        string batch;
+        // File opened again for appending while the writer thread runs, for the crash signal handler (-1 if not open)
+        int crashFileDescriptor;
 };
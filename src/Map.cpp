@@ -1,9 +1,128 @@
 #include "Map.h"
+#include "MappedFile.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <new>
 #include <sstream>
+#include <thread>
+#include <vector>
+
+/* --- TerritorySpan --- */
+
+TerritorySpan::TerritorySpan():
+    first(nullptr),
+    last(nullptr)
+{
+
+}
+
+TerritorySpan::TerritorySpan(Territory* const* first, Territory* const* last):
+    first(first),
+    last(last)
+{
+
+}
+
+Territory* const* TerritorySpan::begin() const
+{
+    return first;
+}
+
+Territory* const* TerritorySpan::end() const
+{
+    return last;
+}
+
+size_t TerritorySpan::size() const
+{
+    return last - first;
+}
+
+bool TerritorySpan::empty() const
+{
+    return first == last;
+}
+
+Territory* TerritorySpan::operator [] (size_t position) const
+{
+    return first[position];
+}
+
+Territory* TerritorySpan::front() const
+{
+    return *first;
+}
+
+std::ostream& operator << (std::ostream& out, const TerritorySpan& source)
+{
+    out << "[";
+    for (const Territory* const territory : source)
+    {
+        out << " " << territory->ID;
+    }
+    out << " ]";
+    return out;
+}
+
+
+/* --- ContinentSpan --- */
+
+ContinentSpan::ContinentSpan():
+    first(nullptr),
+    last(nullptr)
+{
+
+}
+
+ContinentSpan::ContinentSpan(Continent* const* first, Continent* const* last):
+    first(first),
+    last(last)
+{
+
+}
+
+Continent* const* ContinentSpan::begin() const
+{
+    return first;
+}
+
+Continent* const* ContinentSpan::end() const
+{
+    return last;
+}
+
+size_t ContinentSpan::size() const
+{
+    return last - first;
+}
+
+bool ContinentSpan::empty() const
+{
+    return first == last;
+}
+
+Continent* ContinentSpan::operator [] (size_t position) const
+{
+    return first[position];
+}
+
+std::ostream& operator << (std::ostream& out, const ContinentSpan& source)
+{
+    out << "[";
+    for (const Continent* const continent : source)
+    {
+        out << " " << continent->ID;
+    }
+    out << " ]";
+    return out;
+}
+
 
 /* --- Continent --- */
 
@@ -12,36 +131,33 @@ Continent::Continent():
     name(""),
     color(""),
     bonus(0),
-    territories(),
-    territoryIDs()
+    territories()
 {
 
 }
 
-Continent::Continent(int ID, const std::string& name, const std::string& color, int bonus):
+Continent::Continent(int ID, const char* name, const char* color, int bonus):
     ID(ID),
     name(name),
     color(color),
     bonus(bonus),
-    territories(),
-    territoryIDs()
+    territories()
 {
 
 }
 
-// Shallow copy of territory pointers
+// Shallow copy of names and territory pointers
 Continent::Continent(const Continent& other):
     ID(other.ID),
     name(other.name),
     color(other.color),
     bonus(other.bonus),
-    territories(other.territories),
-    territoryIDs(other.territoryIDs)
+    territories(other.territories)
 {
 
 }
 
-// Shallow copy of territory pointers
+// Shallow copy of names and territory pointers
 void Continent::operator = (const Continent& other)
 {
     ID = other.ID;
@@ -49,7 +165,6 @@ void Continent::operator = (const Continent& other)
     color = other.color;
     bonus = other.bonus;
     territories = other.territories;
-    territoryIDs = other.territoryIDs;
 }
 
 Continent::~Continent()
@@ -64,6 +179,59 @@ std::ostream& operator << (std::ostream& out, const Continent& source)
 }
 
 
+/* --- TerritoryIndexSpan --- */
+
+TerritoryIndexSpan::TerritoryIndexSpan():
+    first(nullptr),
+    last(nullptr)
+{
+
+}
+
+TerritoryIndexSpan::TerritoryIndexSpan(const std::uint32_t* first, const std::uint32_t* last):
+    first(first),
+    last(last)
+{
+
+}
+
+const std::uint32_t* TerritoryIndexSpan::begin() const
+{
+    return first;
+}
+
+const std::uint32_t* TerritoryIndexSpan::end() const
+{
+    return last;
+}
+
+size_t TerritoryIndexSpan::size() const
+{
+    return last - first;
+}
+
+bool TerritoryIndexSpan::empty() const
+{
+    return first == last;
+}
+
+std::uint32_t TerritoryIndexSpan::operator [] (size_t position) const
+{
+    return first[position];
+}
+
+std::ostream& operator << (std::ostream& out, const TerritoryIndexSpan& source)
+{
+    out << "[";
+    for (std::uint32_t index : source)
+    {
+        out << " " << index;
+    }
+    out << " ]";
+    return out;
+}
+
+
 /* --- Territory --- */
 
 Territory::Territory():
@@ -74,13 +242,15 @@ Territory::Territory():
     x(0),
     y(0),
     neighbors(),
+    incomingNeighbors(),
     player(nullptr),
+    playerSlot(0),
     armies(0)
 {
 
 }
 
-Territory::Territory(int ID, const std::string& name, Continent* const continent, int x, int y):
+Territory::Territory(int ID, const char* name, Continent* const continent, int x, int y):
     ID(ID),
     name(name),
     continent(continent),
@@ -88,14 +258,15 @@ Territory::Territory(int ID, const std::string& name, Continent* const continent
     x(x),
     y(y),
     neighbors(),
-    neighborIDs(),
+    incomingNeighbors(),
     player(nullptr),
+    playerSlot(0),
     armies(0)
 {
 
 }
 
-// Shallow copy of continent and neighbor pointers
+// Shallow copy of name, continent and neighbor pointers
 Territory::Territory(const Territory& other):
     ID(other.ID),
     name(other.name),
@@ -104,14 +275,15 @@ Territory::Territory(const Territory& other):
     x(other.x),
     y(other.y),
     neighbors(other.neighbors),
-    neighborIDs(other.neighborIDs),
+    incomingNeighbors(other.incomingNeighbors),
     player(other.player),
+    playerSlot(other.playerSlot),
     armies(other.armies)
 {
     
 }
 
-// Shallow copy of continent and neighbor pointers
+// Shallow copy of name, continent and neighbor pointers
 void Territory::operator = (const Territory& other)
     
 {
@@ -122,8 +294,9 @@ void Territory::operator = (const Territory& other)
     x = other.x;
     y = other.y;
     neighbors = other.neighbors;
-    neighborIDs = other.neighborIDs;
+    incomingNeighbors = other.incomingNeighbors;
     player = other.player;
+    playerSlot = other.playerSlot;
     armies = other.armies;
 }
 
@@ -165,16 +338,69 @@ std::ostream& operator << (std::ostream& out, const Map::FormatError source)
     return out;
 }
 
+// Characters of a name, which don't need to be null-terminated
+struct NameRef
+{
+    const char* chars;
+    size_t length;
+};
+
+// Continents, territories and borders of a map as they are read from a file, before Map::build packs them into its arena.
+// Map::build reads it through the same functions as a CompiledMap.
+struct MapLayout
+{
+    size_t getNumContinents() const { return continentNames.size(); }
+    size_t getNumTerritories() const { return territoryNames.size(); }
+    size_t getNumBorders() const { return borders.size(); }
+    // Characters of all the names and colors, with their null terminators
+    size_t getNumChars() const;
+
+    NameRef getContinentName(size_t index) const { return { continentNames[index].data(), continentNames[index].size() }; }
+    NameRef getContinentColor(size_t index) const { return { continentColors[index].data(), continentColors[index].size() }; }
+    int getContinentBonus(size_t index) const { return continentBonuses[index]; }
+
+    int getTerritoryID(size_t index) const { return territoryIDs[index]; }
+    NameRef getTerritoryName(size_t index) const { return { territoryNames[index].data(), territoryNames[index].size() }; }
+    int getTerritoryContinentID(size_t index) const { return territoryContinentIDs[index]; }
+    int getTerritoryX(size_t index) const { return territoryXs[index]; }
+    int getTerritoryY(size_t index) const { return territoryYs[index]; }
+
+    // Fills the adjacency arrays of Map: borders grouped by territory, keeping their file order
+    void copyBorders(std::uint32_t* offsets, std::uint32_t* indices) const;
+
+    // Per continent, in ID order
+    std::vector<std::string> continentNames;
+    std::vector<std::string> continentColors;
+    std::vector<int> continentBonuses;
+
+    // Per territory, in file order (index = ID - 1, unless the file is invalid)
+    std::vector<int> territoryIDs;
+    std::vector<std::string> territoryNames;
+    std::vector<int> territoryContinentIDs;
+    std::vector<int> territoryXs;
+    std::vector<int> territoryYs;
+
+    // Borders as (territory index, neighbor index) pairs, in file order
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> borders;
+};
+
 Map::Map():
     name(""),
     continents(),
-    territories()
+    territories(),
+    arena(nullptr),
+    arenaSize(0),
+    neighborOffsets(nullptr),
+    neighborIndices(nullptr),
+    validated(false),
+    layoutID(0)
 {
 
 }
 
 // Makes a deep copy of the other map and its graph
-Map::Map(const Map& other)
+Map::Map(const Map& other):
+    Map()
 {
     deepCopy(other);
 }
@@ -225,53 +451,85 @@ Territory* Map::getTerritoryByID(int ID) const
     }
 }
 
-// Traditional DFS implementation
-void DFS(const Territory* const node, std::vector<bool>& visited)
+TerritoryIndexSpan Map::getNeighborIndices(size_t territoryIndex) const
+{
+    return TerritoryIndexSpan(neighborIndices + neighborOffsets[territoryIndex], neighborIndices + neighborOffsets[territoryIndex + 1]);
+}
+
+// Iterative BFS over a compressed sparse row graph, starting from a territory index.
+// When continentID is non-zero, only territories of that continent are explored.
+// Visited territories are marked with the provided mark, so the same visited vector can be reused across searches.
+void BFS(const Map& map, const std::uint32_t* offsets, const std::uint32_t* indices,
+         std::uint32_t start, int continentID, std::uint32_t mark, std::vector<std::uint32_t>& visited, std::vector<std::uint32_t>& queue)
 {
-    int territoryIndex = node->ID - 1;
-    visited[territoryIndex] = true;
+    queue.clear();
+    queue.push_back(start);
+    visited[start] = mark;
 
-    for (const Territory* const neighbor : node->neighbors)
+    for (size_t head = 0; head < queue.size(); ++head)
     {
-        int neighborIndex = neighbor->ID - 1;
+        std::uint32_t territoryIndex = queue[head];
 
-        if (!visited.at(neighborIndex))
+        for (std::uint32_t i = offsets[territoryIndex]; i < offsets[territoryIndex + 1]; ++i)
         {
-            DFS(neighbor, visited);
+            std::uint32_t neighborIndex = indices[i];
+
+            if (visited[neighborIndex] != mark && (continentID == 0 || map.territories[neighborIndex]->continentID == continentID))
+            {
+                visited[neighborIndex] = mark;
+                queue.push_back(neighborIndex);
+            }
         }
     }
 }
 
-// Modified DFS implementation: only explores neighbors that belong to the same continent
-void DFSContinent(const Territory* const node, std::vector<bool>& visited)
+Map::FormatError Map::validate() const
 {
-    int territoryIndex = node->ID - 1;
-    visited[territoryIndex] = true;
+    const size_t numTerritories = territories.size();
 
-    for (const Territory* const neighbor : node->neighbors)
+    if (validated || numTerritories == 0)
     {
-        int neighborIndex = neighbor->ID - 1;
+        return Map::FormatError::None;
+    }
 
-        if (node->continentID == neighbor->continentID && !visited.at(neighborIndex))
+    // Borders don't have to be symmetric, so "every territory can reach every other territory"
+    // means strong connectivity: everything is reachable from one territory, following borders
+    // forwards and backwards. Build the reversed borders for the backwards searches.
+    const std::uint32_t numBorders = neighborOffsets[numTerritories];
+    std::vector<std::uint32_t> reverseOffsets(numTerritories + 1, 0);
+    std::vector<std::uint32_t> reverseIndices(numBorders);
+    for (std::uint32_t i = 0; i < numBorders; ++i)
+    {
+        reverseOffsets[neighborIndices[i] + 1]++;
+    }
+    for (size_t i = 0; i < numTerritories; ++i)
+    {
+        reverseOffsets[i + 1] += reverseOffsets[i];
+    }
+    std::vector<std::uint32_t> reverseFill(reverseOffsets.begin(), reverseOffsets.end() - 1);
+    for (std::uint32_t territoryIndex = 0; territoryIndex < numTerritories; ++territoryIndex)
+    {
+        for (std::uint32_t neighborIndex : getNeighborIndices(territoryIndex))
         {
-            DFSContinent(neighbor, visited);
+            reverseIndices[reverseFill[neighborIndex]++] = territoryIndex;
         }
     }
-}
 
-Map::FormatError Map::validate() const
-{
-    const size_t numTerritories = territories.size();
+    // Search marks, 0 means never visited
+    std::vector<std::uint32_t> forwardVisited(numTerritories, 0);
+    std::vector<std::uint32_t> reverseVisited(numTerritories, 0);
+    std::vector<std::uint32_t> queue;
+    queue.reserve(numTerritories);
+    std::uint32_t mark = 1;
 
     // Validation 1: The map is a connected graph
-    // Check that every territory can reach every other territory
-    for (const Territory* const territory : territories)
-    {
-        std::vector<bool> visited(numTerritories);
-
-        DFS(territory, visited);
+    // Check that every territory can reach, and be reached from, the first territory
+    BFS(*this, neighborOffsets, neighborIndices, 0, 0, mark, forwardVisited, queue);
+    BFS(*this, reverseOffsets.data(), reverseIndices.data(), 0, 0, mark, reverseVisited, queue);
 
-        if (find(visited.begin(), visited.end(), false) != visited.end())
+    for (size_t i = 0; i < numTerritories; ++i)
+    {
+        if (forwardVisited[i] != mark || reverseVisited[i] != mark)
         {
             return Map::FormatError::NotConnectedGraph;
         }
@@ -280,53 +538,53 @@ Map::FormatError Map::validate() const
     // Validation 2: Continents are connected subgraphs
     for (const Continent* const continent : continents)
     {
-        // Check that every territory in this continent can reach every other
-        // territory in this continent, using paths that do not leave the
-        // continent.
-        for (const Territory* const territory : continent->territories)
+        if (continent->territories.empty())
         {
-            std::vector<bool> visited(numTerritories);
+            continue;
+        }
 
-            DFSContinent(territory, visited);
+        // Same check as validation 1, using paths that do not leave the continent
+        mark++;
+        const Territory* const first = continent->territories.front();
+        BFS(*this, neighborOffsets, neighborIndices, first->ID - 1, first->continentID, mark, forwardVisited, queue);
+        BFS(*this, reverseOffsets.data(), reverseIndices.data(), first->ID - 1, first->continentID, mark, reverseVisited, queue);
 
-            // Check that every territory in this continent was reached
-            for (const Territory* const territoryCheck : continent->territories)
-            {
-                int territoryCheckIndex = territoryCheck->ID - 1;
+        // Check that every territory in this continent was reached
+        for (const Territory* const territoryCheck : continent->territories)
+        {
+            int territoryCheckIndex = territoryCheck->ID - 1;
 
-                if (visited.at(territoryCheckIndex) == false)
-                {
-                    return FormatError::NotConnectedContinent;
-                }
+            if (forwardVisited.at(territoryCheckIndex) != mark || reverseVisited.at(territoryCheckIndex) != mark)
+            {
+                return FormatError::NotConnectedContinent;
             }
         }
     }
 
     // Validation 3: Each country belongs to one and only one continent
-    for (const Territory* const territory : territories)
+    // Count the continents listing each territory (a continent listing it twice only counts once)
+    std::vector<int> numContinents(numTerritories, 0);
+    std::vector<const Continent*> lastContinent(numTerritories, nullptr);
+    for (const Continent* const continent : continents)
     {
-        bool belongsToContinent = false;
-
-        // Find continents that contain this territory
-        for (const Continent* const continent : continents)
+        for (const Territory* const territory : continent->territories)
         {
-            const std::vector<Territory*>& continentTerritories = continent->territories;
-
-            // Check if this territory belongs to this continent
-            if (find(continentTerritories.begin(), continentTerritories.end(), territory) != continentTerritories.end())
+            size_t territoryIndex = territory->ID - 1;
+            if (lastContinent[territoryIndex] != continent)
             {
-                if (belongsToContinent) // Already belongs to another continent
-                {
-                    return Map::FormatError::TerritoryInMultipleContinents;
-                }
-                else
-                {
-                    belongsToContinent = true;
-                }
+                lastContinent[territoryIndex] = continent;
+                numContinents[territoryIndex]++;
             }
         }
+    }
 
-        if (!belongsToContinent) // This territory belongs to no continent at all
+    for (size_t i = 0; i < numTerritories; ++i)
+    {
+        if (numContinents[i] > 1) // Belongs to several continents
+        {
+            return Map::FormatError::TerritoryInMultipleContinents;
+        }
+        else if (numContinents[i] == 0) // This territory belongs to no continent at all
         {
             return Map::FormatError::TerritoryNotInAContinent;
         }
@@ -337,19 +595,40 @@ Map::FormatError Map::validate() const
 
 void Map::releaseAllocs()
 {
-    for (const Continent* const continent : continents)
+    releaseArena();
+
+    validated = false;
+    layoutID = 0;
+    name.clear();
+}
+
+void Map::assign(const Map& other)
+{
+    if (this == &other)
     {
-        delete continent;
+        return;
     }
 
-    for (const Territory* const territory : territories)
+    // Different graph, nothing can be reused
+    if (layoutID == 0 || layoutID != other.layoutID)
     {
-        delete territory;
+        deepCopy(other);
+        return;
     }
 
-    territories.clear();
-    continents.clear();
-    name.clear();
+    for (size_t i = 0; i < territories.size(); ++i)
+    {
+        territories[i]->player = other.territories[i]->player;
+        territories[i]->playerSlot = other.territories[i]->playerSlot;
+        territories[i]->armies = other.territories[i]->armies;
+    }
+}
+
+// Moves a pointer into one arena to the same place in another arena
+template <typename T>
+static T* rebase(T* pointer, const char* fromArena, char* toArena)
+{
+    return reinterpret_cast<T*>(toArena + (reinterpret_cast<const char*>(pointer) - fromArena));
 }
 
 void Map::deepCopy(const Map& other)
@@ -357,57 +636,275 @@ void Map::deepCopy(const Map& other)
     releaseAllocs();
 
     name = other.name;
+    validated = other.validated;
+    layoutID = other.layoutID;
 
-    for (const Territory* const otherTerritory : other.territories)
+    if (other.arena == nullptr)
     {
-        Territory* newTerritory = new Territory(*otherTerritory);
-        territories.push_back(newTerritory);
+        return;
     }
 
-    for (const Continent* const otherContinent : other.continents)
+    // Bulk copy of the whole arena, after which every pointer into the other arena gets moved to this one
+    arena = static_cast<char*>(::operator new(other.arenaSize));
+    arenaSize = other.arenaSize;
+    std::memcpy(arena, other.arena, arenaSize);
+
+    const char* const otherArena = other.arena;
+
+    continents = ContinentSpan(rebase(other.continents.begin(), otherArena, arena), rebase(other.continents.end(), otherArena, arena));
+    territories = TerritorySpan(rebase(other.territories.begin(), otherArena, arena), rebase(other.territories.end(), otherArena, arena));
+    neighborOffsets = rebase(other.neighborOffsets, otherArena, arena);
+    neighborIndices = rebase(other.neighborIndices, otherArena, arena);
+
+    Continent** continentSlots = const_cast<Continent**>(continents.begin());
+    for (size_t i = 0; i < continents.size(); ++i)
     {
-        Continent* newContinent = new Continent(*otherContinent);
-        continents.push_back(newContinent);
+        Continent* const otherContinent = other.continents[i];
+        Continent* continent = new (rebase(otherContinent, otherArena, arena)) Continent(*otherContinent);
+        continentSlots[i] = continent;
+
+        continent->name = rebase(continent->name, otherArena, arena);
+        continent->color = rebase(continent->color, otherArena, arena);
+        continent->territories = TerritorySpan(rebase(continent->territories.begin(), otherArena, arena), rebase(continent->territories.end(), otherArena, arena));
 
         // Re-assign territory pointers
-        for (size_t i = 0; i < newContinent->territoryIDs.size(); ++i)
+        Territory** memberSlots = const_cast<Territory**>(continent->territories.begin());
+        for (size_t j = 0; j < continent->territories.size(); ++j)
+        {
+            memberSlots[j] = rebase(otherContinent->territories[j], otherArena, arena);
+        }
+    }
+
+    Territory** territorySlots = const_cast<Territory**>(territories.begin());
+    for (size_t i = 0; i < territories.size(); ++i)
+    {
+        Territory* const otherTerritory = other.territories[i];
+        Territory* territory = new (rebase(otherTerritory, otherArena, arena)) Territory(*otherTerritory);
+        territorySlots[i] = territory;
+
+        // Re-assign name, continent and neighbor pointers
+        territory->name = rebase(territory->name, otherArena, arena);
+        territory->continent = rebase(territory->continent, otherArena, arena);
+        territory->neighbors = TerritorySpan(rebase(territory->neighbors.begin(), otherArena, arena), rebase(territory->neighbors.end(), otherArena, arena));
+        territory->incomingNeighbors = TerritorySpan(rebase(territory->incomingNeighbors.begin(), otherArena, arena), rebase(territory->incomingNeighbors.end(), otherArena, arena));
+
+        Territory** neighborSlots = const_cast<Territory**>(territory->neighbors.begin());
+        for (size_t j = 0; j < territory->neighbors.size(); ++j)
+        {
+            neighborSlots[j] = rebase(otherTerritory->neighbors[j], otherArena, arena);
+        }
+
+        Territory** incomingSlots = const_cast<Territory**>(territory->incomingNeighbors.begin());
+        for (size_t j = 0; j < territory->incomingNeighbors.size(); ++j)
         {
-            int territoryIndex = newContinent->territoryIDs[i] - 1;
-            newContinent->territories[i] = territories.at(territoryIndex);
+            incomingSlots[j] = rebase(otherTerritory->incomingNeighbors[j], otherArena, arena);
         }
     }
+}
+
+// Reserves room for count values of T at the end of an arena of the given size, and returns their offset
+template <typename T>
+static size_t reserveArena(size_t& arenaSize, size_t count)
+{
+    const size_t offset = (arenaSize + alignof(T) - 1) / alignof(T) * alignof(T);
+    arenaSize = offset + sizeof(T) * count;
+    return offset;
+}
+
+// Copies a name, adding a null terminator, to the next free characters of an arena
+static const char* copyToArena(char*& nextChar, NameRef value)
+{
+    char* copy = nextChar;
+    std::memcpy(copy, value.chars, value.length);
+    copy[value.length] = '\0';
+    nextChar += value.length + 1;
+    return copy;
+}
+
+size_t MapLayout::getNumChars() const
+{
+    size_t numChars = 0;
+    for (size_t i = 0; i < continentNames.size(); ++i)
+    {
+        numChars += continentNames[i].size() + 1 + continentColors[i].size() + 1;
+    }
+    for (const std::string& territoryName : territoryNames)
+    {
+        numChars += territoryName.size() + 1;
+    }
+    return numChars;
+}
+
+void MapLayout::copyBorders(std::uint32_t* offsets, std::uint32_t* indices) const
+{
+    const size_t numTerritories = territoryNames.size();
+
+    std::fill(offsets, offsets + numTerritories + 1, 0);
+    for (const std::pair<std::uint32_t, std::uint32_t>& border : borders)
+    {
+        offsets[border.first + 1]++;
+    }
+    for (size_t i = 0; i < numTerritories; ++i)
+    {
+        offsets[i + 1] += offsets[i];
+    }
+
+    std::vector<std::uint32_t> nextNeighbor(offsets, offsets + numTerritories);
+    for (const std::pair<std::uint32_t, std::uint32_t>& border : borders)
+    {
+        indices[nextNeighbor[border.first]++] = border.second;
+    }
+}
 
-    for (Territory* newTerritory : territories)
+template <typename Tables>
+void Map::build(const Tables& tables)
+{
+    releaseArena();
+
+    const size_t numContinents = tables.getNumContinents();
+    const size_t numTerritories = tables.getNumTerritories();
+    const size_t numBorders = tables.getNumBorders();
+    const size_t numChars = tables.getNumChars();
+
+    size_t size = 0;
+    const size_t continentsOffset = reserveArena<Continent>(size, numContinents);
+    const size_t territoriesOffset = reserveArena<Territory>(size, numTerritories);
+    const size_t continentSlotsOffset = reserveArena<Continent*>(size, numContinents);
+    const size_t territorySlotsOffset = reserveArena<Territory*>(size, numTerritories);
+    const size_t memberSlotsOffset = reserveArena<Territory*>(size, numTerritories);
+    const size_t neighborSlotsOffset = reserveArena<Territory*>(size, numBorders);
+    const size_t incomingSlotsOffset = reserveArena<Territory*>(size, numBorders);
+    const size_t neighborOffsetsOffset = reserveArena<std::uint32_t>(size, numTerritories + 1);
+    const size_t neighborIndicesOffset = reserveArena<std::uint32_t>(size, numBorders);
+    const size_t charsOffset = reserveArena<char>(size, numChars);
+
+    arena = static_cast<char*>(::operator new(size));
+    arenaSize = size;
+
+    Continent** continentSlots = reinterpret_cast<Continent**>(arena + continentSlotsOffset);
+    Territory** territorySlots = reinterpret_cast<Territory**>(arena + territorySlotsOffset);
+    Territory** memberSlots = reinterpret_cast<Territory**>(arena + memberSlotsOffset);
+    Territory** neighborSlots = reinterpret_cast<Territory**>(arena + neighborSlotsOffset);
+    Territory** incomingSlots = reinterpret_cast<Territory**>(arena + incomingSlotsOffset);
+    std::uint32_t* offsets = reinterpret_cast<std::uint32_t*>(arena + neighborOffsetsOffset);
+    std::uint32_t* indices = reinterpret_cast<std::uint32_t*>(arena + neighborIndicesOffset);
+    char* nextChar = arena + charsOffset;
+
+    for (size_t i = 0; i < numContinents; ++i)
     {
-        // Re-assign continent pointer
-        int continentIndex = newTerritory->continent->ID - 1;
-        newTerritory->continent = continents[continentIndex];
+        const char* continentName = copyToArena(nextChar, tables.getContinentName(i));
+        const char* continentColor = copyToArena(nextChar, tables.getContinentColor(i));
+        Continent* continent = reinterpret_cast<Continent*>(arena + continentsOffset) + i;
+
+        continentSlots[i] = new (continent) Continent(static_cast<int>(i + 1), continentName, continentColor, tables.getContinentBonus(i));
+    }
+
+    // Continent members are grouped by continent, in territory order
+    std::vector<std::uint32_t> memberOffsets(numContinents + 1, 0);
+    for (size_t i = 0; i < numTerritories; ++i)
+    {
+        memberOffsets[tables.getTerritoryContinentID(i)]++;
+    }
+    for (size_t i = 0; i < numContinents; ++i)
+    {
+        memberOffsets[i + 1] += memberOffsets[i];
+    }
+
+    tables.copyBorders(offsets, indices);
+
+    std::vector<std::uint32_t> nextMember(memberOffsets.begin(), memberOffsets.end() - 1);
+    for (size_t i = 0; i < numTerritories; ++i)
+    {
+        const char* territoryName = copyToArena(nextChar, tables.getTerritoryName(i));
+        const size_t continentIndex = tables.getTerritoryContinentID(i) - 1;
+        Territory* territory = reinterpret_cast<Territory*>(arena + territoriesOffset) + i;
+
+        territorySlots[i] = new (territory) Territory(tables.getTerritoryID(i), territoryName, continentSlots[continentIndex], tables.getTerritoryX(i), tables.getTerritoryY(i));
+        territory->neighbors = TerritorySpan(neighborSlots + offsets[i], neighborSlots + offsets[i + 1]);
+        memberSlots[nextMember[continentIndex]++] = territory;
+    }
+
+    for (size_t i = 0; i < numBorders; ++i)
+    {
+        neighborSlots[i] = territorySlots[indices[i]];
+    }
 
-        // Re-assign neighbor pointers
-        for (size_t i = 0; i < newTerritory->neighborIDs.size(); ++i)
+    // Incoming borders are grouped by the territory they lead to, in territory order
+    std::vector<std::uint32_t> incomingOffsets(numTerritories + 1, 0);
+    for (size_t i = 0; i < numBorders; ++i)
+    {
+        incomingOffsets[indices[i] + 1]++;
+    }
+    for (size_t i = 0; i < numTerritories; ++i)
+    {
+        incomingOffsets[i + 1] += incomingOffsets[i];
+    }
+
+    std::vector<std::uint32_t> nextIncoming(incomingOffsets.begin(), incomingOffsets.end() - 1);
+    for (size_t i = 0; i < numTerritories; ++i)
+    {
+        for (std::uint32_t j = offsets[i]; j < offsets[i + 1]; ++j)
         {
-            int territoryIndex = newTerritory->neighborIDs[i] - 1;
-            newTerritory->neighbors[i] = territories.at(territoryIndex);
+            incomingSlots[nextIncoming[indices[j]]++] = territorySlots[i];
         }
     }
+
+    for (size_t i = 0; i < numTerritories; ++i)
+    {
+        territorySlots[i]->incomingNeighbors = TerritorySpan(incomingSlots + incomingOffsets[i], incomingSlots + incomingOffsets[i + 1]);
+    }
+
+    for (size_t i = 0; i < numContinents; ++i)
+    {
+        continentSlots[i]->territories = TerritorySpan(memberSlots + memberOffsets[i], memberSlots + memberOffsets[i + 1]);
+    }
+
+    continents = ContinentSpan(continentSlots, continentSlots + numContinents);
+    territories = TerritorySpan(territorySlots, territorySlots + numTerritories);
+    neighborOffsets = offsets;
+    neighborIndices = indices;
+}
+
+void Map::releaseArena()
+{
+    for (Continent* const continent : continents)
+    {
+        continent->~Continent();
+    }
+
+    for (Territory* const territory : territories)
+    {
+        territory->~Territory();
+    }
+
+    ::operator delete(arena);
+
+    arena = nullptr;
+    arenaSize = 0;
+    continents = ContinentSpan();
+    territories = TerritorySpan();
+    neighborOffsets = nullptr;
+    neighborIndices = nullptr;
 }
 
 
 /* --- MapLoader --- */
 
-MapLoader::MapLoader()
+MapLoader::MapLoader():
+    cacheEnabled(true)
 {
 
 }
 
-MapLoader::MapLoader(const MapLoader& other)
+MapLoader::MapLoader(const MapLoader& other):
+    cacheEnabled(other.cacheEnabled)
 {
 
 }
 
 void MapLoader::operator = (const MapLoader& other)
 {
-    return;
+    cacheEnabled = other.cacheEnabled;
 }
 
 MapLoader::~MapLoader()
@@ -421,6 +918,9 @@ std::ostream& operator << (std::ostream& out, const MapLoader& source)
     return out;
 }
 
+// Source of Map::layoutID values, unique across every load of the process
+static std::atomic<std::uint64_t> nextLayoutID(1);
+
 // Tiny state machine for MapLoader::load
 enum class ParserState
 {
@@ -451,178 +951,324 @@ Map::FormatError MapLoader::load(const std::string& filepath, Map& destination,
     }
     destination.name = filepath.substr(sepIdx, dotIdx - sepIdx);
 
-    std::ifstream inputFile(filepath);
-    std::string line;
+    // The whole file is tokenized in place, nothing is copied except the names that the map keeps
+    MappedFile inputFile;
 
     // Check that the file exists
-    if (!inputFile.good())
+    if (!inputFile.open(filepath))
     {
         return Map::FormatError::FileDoesNotExist;
     }
 
+    const std::string compiledPath = getCompiledPath(filepath);
+
+    // Skip parsing and validation entirely if this file was already compiled
+    if (cacheEnabled && loadCompiled(compiledPath, inputFile, destination))
+    {
+        destination.layoutID = nextLayoutID++;
+        errorLine = -1;
+        return Map::FormatError::None;
+    }
+
+    MapLayout layout;
+    Map::FormatError result = parse(inputFile, layout, errorLine);
+
+    // Also done on failure, so that the partially loaded map stays consistent
+    destination.build(layout);
+
+    // Only valid maps are compiled, invalid ones get validated again on every load to report their error
+    if (cacheEnabled && result == Map::FormatError::None && destination.validate() == Map::FormatError::None)
+    {
+        destination.validated = true;
+        saveCompiled(compiledPath, inputFile, destination);
+    }
+
+    if (result == Map::FormatError::None)
+    {
+        destination.layoutID = nextLayoutID++;
+    }
+
+    return result;
+}
+
+void MapLoader::setCacheEnabled(bool enabled)
+{
+    cacheEnabled = enabled;
+}
+
+bool MapLoader::isCacheEnabled() const
+{
+    return cacheEnabled;
+}
+
+std::string MapLoader::getCompiledPath(const std::string& filepath)
+{
+    // Only look for the extension in the filename itself
+    size_t sepIdx = 0;
+    for (size_t i = 0; i < filepath.size(); ++i)
+    {
+        const char& currentChar = filepath.at(i);
+        if (currentChar == '/' || currentChar == '\\' || currentChar == ':')
+        {
+            sepIdx = i + 1;
+        }
+    }
+
+    size_t dotIdx = filepath.find_last_of('.');
+    if (dotIdx == std::string::npos || dotIdx < sepIdx)
+    {
+        dotIdx = filepath.size();
+    }
+
+    return filepath.substr(0, dotIdx) + ".wzmap";
+}
+
+// Whitespace as seen by std::istream in the "C" locale
+static bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+// Checks if a token is exactly the given text
+static bool tokenEquals(const char* first, const char* last, const char* text)
+{
+    const size_t length = std::strlen(text);
+    return static_cast<size_t>(last - first) == length && std::memcmp(first, text, length) == 0;
+}
+
+// Reads the next whitespace-delimited token of a line, moving the cursor past it.
+// Returns false, with an empty token, if the line has no more tokens.
+static bool readToken(const char*& cursor, const char* end, const char*& tokenFirst, const char*& tokenLast)
+{
+    while (cursor != end && isSpace(*cursor))
+    {
+        ++cursor;
+    }
+
+    tokenFirst = cursor;
+    while (cursor != end && !isSpace(*cursor))
+    {
+        ++cursor;
+    }
+    tokenLast = cursor;
+
+    return tokenFirst != tokenLast;
+}
+
+// Parses a base 10 integer (optional sign, then digits) at the cursor, moving the cursor past it.
+// Stops at the first character that isn't a digit, like std::from_chars and std::istream do.
+// Returns false if there are no digits or the value doesn't fit in an int.
+// reachedEnd tells if the parse ran into the end of the range, which std::istream reports as eof.
+static bool parseInt(const char*& cursor, const char* end, int& value, bool& reachedEnd)
+{
+    bool negative = false;
+    if (cursor != end && (*cursor == '-' || *cursor == '+'))
+    {
+        negative = *cursor == '-';
+        ++cursor;
+    }
+
+    const std::uint64_t limit = negative ? 2147483648ULL : 2147483647ULL;
+    std::uint64_t magnitude = 0;
+    bool hasDigits = false;
+    bool overflow = false;
+
+    while (cursor != end && *cursor >= '0' && *cursor <= '9')
+    {
+        hasDigits = true;
+        if (!overflow)
+        {
+            magnitude = magnitude * 10 + static_cast<std::uint64_t>(*cursor - '0');
+            overflow = magnitude > limit;
+        }
+        ++cursor;
+    }
+
+    reachedEnd = cursor == end;
+
+    if (!hasDigits || overflow)
+    {
+        return false;
+    }
+
+    value = negative ? static_cast<int>(-static_cast<std::int64_t>(magnitude)) : static_cast<int>(magnitude);
+    return true;
+}
+
+// Reads the next integer of a line like std::istream's operator >> (skipping whitespace first)
+static bool readInt(const char*& cursor, const char* end, int& value, bool& reachedEnd)
+{
+    while (cursor != end && isSpace(*cursor))
+    {
+        ++cursor;
+    }
+
+    if (cursor == end)
+    {
+        reachedEnd = true;
+        return false;
+    }
+
+    return parseInt(cursor, end, value, reachedEnd);
+}
+
+// Parses the integer at the start of a token, ignoring anything after it, like std::stoi does
+static bool parseTokenInt(const char* tokenFirst, const char* tokenLast, int& value)
+{
+    bool reachedEnd;
+    return parseInt(tokenFirst, tokenLast, value, reachedEnd);
+}
+
+Map::FormatError MapLoader::parse(const MappedFile& inputFile, MapLayout& layout, int& errorLine) const
+{
     ParserState state = ParserState::Heading;
-    int continentID = 1;
+
+    const char* fileEnd = inputFile.end();
+    const char* lineFirst = inputFile.begin();
 
     // Read line by line
-    while (std::getline(inputFile, line))
+    while (lineFirst != fileEnd)
     {
+        const char* lineLast = static_cast<const char*>(std::memchr(lineFirst, '\n', fileEnd - lineFirst));
+        const char* nextLine = lineLast != nullptr ? lineLast + 1 : fileEnd;
+        if (lineLast == nullptr)
+        {
+            lineLast = fileEnd;
+        }
+
+        const char* cursor = lineFirst;
+        lineFirst = nextLine;
+
         errorLine++;
 
-        // Skipping empty line
-        if (line.length() <= 0)
+        const char* firstWord;
+        const char* firstWordEnd;
+
+        // Skipping comments and empty lines
+        if (!readToken(cursor, lineLast, firstWord, firstWordEnd) || *firstWord == ';')
         {
             continue;
         }
-        else
-        {
-            std::istringstream l = std::istringstream(line);
 
-            std::string firstWord;
-            l >> firstWord;
+        // Exit current state and prepare to parse a heading
+        if (*firstWord == '[')
+        {
+            state = ParserState::Heading;
+        }
 
-            // Skipping comments and empty lines
-            if (firstWord == ";" || firstWord.size() <= 0 || firstWord.front() == ';')
+        if (state == ParserState::Heading)
+        {
+            if (tokenEquals(firstWord, firstWordEnd, "[continents]"))
             {
-                continue;
+                state = ParserState::Continent;
             }
+            else if (tokenEquals(firstWord, firstWordEnd, "[countries]"))
+            {
+                state = ParserState::Territory;
+            }
+            else if (tokenEquals(firstWord, firstWordEnd, "[borders]"))
+            {
+                state = ParserState::Border;
+            }
+        }
+        else if (state == ParserState::Continent)
+        {
+            int bonus;
+            const char* color;
+            const char* colorEnd;
+            bool reachedEnd;
 
-            // Exit current state and prepare to parse a heading
-            if (firstWord.front() == '[')
+            // Check for format errors
+            if (!readInt(cursor, lineLast, bonus, reachedEnd) || !readToken(cursor, lineLast, color, colorEnd))
             {
-                state = ParserState::Heading;
+                return Map::FormatError::BadContinentFormat;
             }
 
-            if (state == ParserState::Heading)
+            layout.continentNames.emplace_back(firstWord, firstWordEnd);
+            layout.continentColors.emplace_back(color, colorEnd);
+            layout.continentBonuses.push_back(bonus);
+        }
+        else if (state == ParserState::Territory)
+        {
+            int ID;
+            if (!parseTokenInt(firstWord, firstWordEnd, ID))
             {
-                if (firstWord == "[continents]")
-                {
-                    state = ParserState::Continent;
-                }
-                else if (firstWord == "[countries]")
-                {
-                    state = ParserState::Territory;
-                }
-                else if (firstWord == "[borders]")
-                {
-                    state = ParserState::Border;
-                }
+                return Map::FormatError::BadTerritoryFormat;
             }
-            else if (state == ParserState::Continent)
+
+            const char* name;
+            const char* nameEnd;
+            int continentID;
+            int x;
+            int y;
+            bool reachedEnd;
+
+            // Check for format errors
+            if (!readToken(cursor, lineLast, name, nameEnd) ||
+                !readInt(cursor, lineLast, continentID, reachedEnd) ||
+                !readInt(cursor, lineLast, x, reachedEnd) ||
+                !readInt(cursor, lineLast, y, reachedEnd))
             {
-                std::string name = firstWord;
-                int bonus;
-                std::string color;
+                return Map::FormatError::BadTerritoryFormat;
+            }
 
-                l >> bonus >> color;
+            // Check that the continent exists
+            if (continentID < 1 || static_cast<size_t>(continentID) > layout.continentNames.size())
+            {
+                return Map::FormatError::BadTerritoryFormat;
+            }
 
-                // Check for format errors
-                if (l.fail())
-                {
-                    return Map::FormatError::BadContinentFormat;
-                }
+            layout.territoryIDs.push_back(ID);
+            layout.territoryNames.emplace_back(name, nameEnd);
+            layout.territoryContinentIDs.push_back(continentID);
+            layout.territoryXs.push_back(x);
+            layout.territoryYs.push_back(y);
 
-                Continent* continent = new Continent(continentID++, name, color, bonus);
-                destination.continents.push_back(continent);
+            // Ensure the territories are in perfect sequential order
+            if (layout.territoryIDs.size() != ID)
+            {
+                return Map::FormatError::BadTerritoryFormat;
             }
-            else if (state == ParserState::Territory)
+        }
+        else if (state == ParserState::Border)
+        {
+            int ID;
+            if (!parseTokenInt(firstWord, firstWordEnd, ID))
             {
-                int ID = -1;
-                try
-                {
-                    ID = std::stoi(firstWord);
-                }
-                catch (const std::invalid_argument&)
-                {
-                    return Map::FormatError::BadTerritoryFormat;
-                }
-                catch (const std::out_of_range&)
-                {
-                    return Map::FormatError::BadTerritoryFormat;
-                }
-
-                std::string name;
-                int continentID;
-                int x;
-                int y;
-
-                l >> name >> continentID >> x >> y;
-
-                // Check for format errors
-                if (l.fail())
-                {
-                    return Map::FormatError::BadTerritoryFormat;
-                }
-
-                Continent* continent = destination.getContinentByID(continentID);
-
-                // Check that the continent exists
-                if (continent == nullptr)
-                {
-                    return Map::FormatError::BadTerritoryFormat;
-                }
-
-                Territory* territory = new Territory(ID, name, continent, x, y);
+                return Map::FormatError::BadBorderFormat;
+            }
 
-                continent->territories.push_back(territory);
-                continent->territoryIDs.push_back(territory->ID);
-                destination.territories.push_back(territory);
+            const size_t numTerritories = layout.territoryIDs.size();
 
-                // Ensure the territories are in perfect sequential order
-                if (destination.territories.size() != ID)
-                {
-                    return Map::FormatError::BadTerritoryFormat;
-                }
+            // Check that territory exists
+            if (ID < 1 || static_cast<size_t>(ID) > numTerritories)
+            {
+                return Map::FormatError::BadBorderFormat;
             }
-            else if (state == ParserState::Border)
+
+            int neighborID;
+            bool reachedEnd = false;
+            while (readInt(cursor, lineLast, neighborID, reachedEnd))
             {
-                int ID = -1;
-                try
-                {
-                    ID = std::stoi(firstWord);
-                }
-                catch (const std::invalid_argument&)
+                // Self-loop
+                if (neighborID == ID)
                 {
                     return Map::FormatError::BadBorderFormat;
                 }
-                catch (const std::out_of_range&)
-                {
-                    return Map::FormatError::BadBorderFormat;
-                }
-
-                Territory* territory = destination.getTerritoryByID(ID);
 
-                // Check that territory exists
-                if (territory == nullptr)
+                // Check that neighbor exists
+                if (neighborID < 1 || static_cast<size_t>(neighborID) > numTerritories)
                 {
                     return Map::FormatError::BadBorderFormat;
                 }
 
-                int neighborID;
-                while (l >> neighborID)
-                {
-                    // Self-loop
-                    if (neighborID == ID)
-                    {
-                        return Map::FormatError::BadBorderFormat;
-                    }
-
-                    Territory* neighbor = destination.getTerritoryByID(neighborID);
-
-                    // Check that neighbor exists
-                    if (neighbor == nullptr)
-                    {
-                        return Map::FormatError::BadBorderFormat;
-                    }
-
-                    territory->neighbors.push_back(neighbor);
-                    territory->neighborIDs.push_back(neighborID);
-                }
+                layout.borders.emplace_back(static_cast<std::uint32_t>(ID - 1), static_cast<std::uint32_t>(neighborID - 1));
+            }
 
-                // Did we miss any borders because of a bad intermediate value?
-                if (!l.eof())
-                {
-                    return Map::FormatError::BadBorderFormat;
-                }
+            // Did we miss any borders because of a bad intermediate value?
+            if (!reachedEnd)
+            {
+                return Map::FormatError::BadBorderFormat;
             }
         }
     }
@@ -631,6 +1277,328 @@ Map::FormatError MapLoader::load(const std::string& filepath, Map& destination,
     // which aren't related to a specific line.
     errorLine = -1;
 
-    inputFile.close();
     return Map::FormatError::None;
 }
+
+// Layout of a compiled map file (.wzmap), all values in native byte order:
+// - CompiledMapHeader
+// - CompiledContinent table, in ID order
+// - CompiledTerritory table, in ID order
+// - Border offsets (numTerritories + 1 values), then border indices (numBorders values), as in Map's adjacency arrays
+// - String pool holding every name and color, referenced by offset and length
+// The header and records are made of 4 and 8 byte values, so that every table is 4-byte aligned in a mapping of the file,
+// which starts on a page boundary, and is read in place.
+struct CompiledMapHeader
+{
+    // Identifies the file format, a mismatch means the file can't be read
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t numContinents;
+    std::uint32_t numTerritories;
+    std::uint32_t numBorders;
+    std::uint64_t stringPoolSize;
+    // Size and modification time of the map file this was compiled from, a mismatch means the map file may have changed
+    std::uint64_t sourceSize;
+    std::int64_t sourceModificationTime;
+    // Hash of the map file, which tells if the map file really changed when only its modification time differs
+    std::uint64_t sourceHash;
+};
+
+struct CompiledContinent
+{
+    std::uint32_t nameOffset;
+    std::uint32_t nameLength;
+    std::uint32_t colorOffset;
+    std::uint32_t colorLength;
+    std::int32_t bonus;
+};
+
+struct CompiledTerritory
+{
+    std::uint32_t nameOffset;
+    std::uint32_t nameLength;
+    std::int32_t continentID;
+    std::int32_t x;
+    std::int32_t y;
+};
+
+static const char compiledMapMagic[8] = { 'W', 'Z', 'M', 'A', 'P', '\0', '\0', '\0' };
+static const std::uint32_t compiledMapVersion = 2;
+
+// The tables of a compiled map, pointing into the mapped file.
+// Map::build reads it through the same functions as a MapLayout.
+struct CompiledMap
+{
+    size_t getNumContinents() const { return numContinents; }
+    size_t getNumTerritories() const { return numTerritories; }
+    size_t getNumBorders() const { return numBorders; }
+    // Characters of all the names and colors, with their null terminators
+    size_t getNumChars() const { return numChars; }
+
+    NameRef getContinentName(size_t index) const { return { stringPool + continents[index].nameOffset, continents[index].nameLength }; }
+    NameRef getContinentColor(size_t index) const { return { stringPool + continents[index].colorOffset, continents[index].colorLength }; }
+    int getContinentBonus(size_t index) const { return continents[index].bonus; }
+
+    int getTerritoryID(size_t index) const { return static_cast<int>(index + 1); }
+    NameRef getTerritoryName(size_t index) const { return { stringPool + territories[index].nameOffset, territories[index].nameLength }; }
+    int getTerritoryContinentID(size_t index) const { return territories[index].continentID; }
+    int getTerritoryX(size_t index) const { return territories[index].x; }
+    int getTerritoryY(size_t index) const { return territories[index].y; }
+
+    // Fills the adjacency arrays of Map, which the file holds as they are
+    void copyBorders(std::uint32_t* offsets, std::uint32_t* indices) const;
+
+    // Checks every value that Map::build uses as an offset or index, and counts the characters of the names
+    bool check(std::uint64_t stringPoolSize);
+
+    const CompiledContinent* continents;
+    const CompiledTerritory* territories;
+    const std::uint32_t* neighborOffsets;
+    const std::uint32_t* neighborIndices;
+    const char* stringPool;
+    size_t numContinents;
+    size_t numTerritories;
+    size_t numBorders;
+    size_t numChars;
+};
+
+void CompiledMap::copyBorders(std::uint32_t* offsets, std::uint32_t* indices) const
+{
+    std::memcpy(offsets, neighborOffsets, sizeof(std::uint32_t) * (numTerritories + 1));
+    if (numBorders > 0)
+    {
+        std::memcpy(indices, neighborIndices, sizeof(std::uint32_t) * numBorders);
+    }
+}
+
+bool CompiledMap::check(std::uint64_t stringPoolSize)
+{
+    std::uint64_t chars = 0;
+
+    for (size_t i = 0; i < numContinents; ++i)
+    {
+        const CompiledContinent& continent = continents[i];
+        if (static_cast<std::uint64_t>(continent.nameOffset) + continent.nameLength > stringPoolSize ||
+            static_cast<std::uint64_t>(continent.colorOffset) + continent.colorLength > stringPoolSize)
+        {
+            return false;
+        }
+        chars += static_cast<std::uint64_t>(continent.nameLength) + 1 + continent.colorLength + 1;
+    }
+
+    for (size_t i = 0; i < numTerritories; ++i)
+    {
+        const CompiledTerritory& territory = territories[i];
+        if (static_cast<std::uint64_t>(territory.nameOffset) + territory.nameLength > stringPoolSize ||
+            territory.continentID < 1 || static_cast<std::uint64_t>(territory.continentID) > numContinents)
+        {
+            return false;
+        }
+        chars += static_cast<std::uint64_t>(territory.nameLength) + 1;
+    }
+
+    if (neighborOffsets[0] != 0 || neighborOffsets[numTerritories] != numBorders)
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < numTerritories; ++i)
+    {
+        if (neighborOffsets[i] > neighborOffsets[i + 1])
+        {
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < numBorders; ++i)
+    {
+        if (neighborIndices[i] >= numTerritories)
+        {
+            return false;
+        }
+    }
+
+    numChars = static_cast<size_t>(chars);
+    return true;
+}
+
+// 64-bit FNV-1a hash
+static std::uint64_t hashBytes(const char* first, const char* last)
+{
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+    for (const char* c = first; c != last; ++c)
+    {
+        hash ^= static_cast<unsigned char>(*c);
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+// Appends the raw bytes of a value to a buffer
+template <typename T>
+static void appendBytes(std::vector<char>& buffer, const T* values, size_t count)
+{
+    const char* bytes = reinterpret_cast<const char*>(values);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(T) * count);
+}
+
+// Adds a string to the pool, returning its offset and length
+static std::uint32_t addToStringPool(std::string& stringPool, const char* value, std::uint32_t& length)
+{
+    std::uint32_t offset = static_cast<std::uint32_t>(stringPool.size());
+    length = static_cast<std::uint32_t>(std::strlen(value));
+    stringPool.append(value, length);
+    return offset;
+}
+
+bool MapLoader::loadCompiled(const std::string& compiledPath, const MappedFile& source, Map& destination) const
+{
+    MappedFile compiledFile;
+    if (!compiledFile.open(compiledPath) || compiledFile.size() < sizeof(CompiledMapHeader))
+    {
+        return false;
+    }
+
+    const CompiledMapHeader& header = *reinterpret_cast<const CompiledMapHeader*>(compiledFile.begin());
+
+    if (std::memcmp(header.magic, compiledMapMagic, sizeof(compiledMapMagic)) != 0 ||
+        header.version != compiledMapVersion ||
+        header.sourceSize != source.size() ||
+        header.stringPoolSize > compiledFile.size())
+    {
+        return false;
+    }
+
+    // A map file with the same size and modification time wasn't edited, only hash the ones that were touched
+    const bool sourceTouched = header.sourceModificationTime != source.getModificationTime();
+    if (sourceTouched && header.sourceHash != hashBytes(source.begin(), source.end()))
+    {
+        return false;
+    }
+
+    const std::uint64_t numContinents = header.numContinents;
+    const std::uint64_t numTerritories = header.numTerritories;
+    const std::uint64_t numBorders = header.numBorders;
+    const std::uint64_t expectedSize = sizeof(CompiledMapHeader)
+        + numContinents * sizeof(CompiledContinent)
+        + numTerritories * sizeof(CompiledTerritory)
+        + (numTerritories + 1 + numBorders) * sizeof(std::uint32_t)
+        + header.stringPoolSize;
+
+    if (compiledFile.size() != expectedSize)
+    {
+        return false;
+    }
+
+    CompiledMap compiled;
+    const char* cursor = compiledFile.begin() + sizeof(CompiledMapHeader);
+    compiled.continents = reinterpret_cast<const CompiledContinent*>(cursor);
+    cursor += numContinents * sizeof(CompiledContinent);
+    compiled.territories = reinterpret_cast<const CompiledTerritory*>(cursor);
+    cursor += numTerritories * sizeof(CompiledTerritory);
+    compiled.neighborOffsets = reinterpret_cast<const std::uint32_t*>(cursor);
+    cursor += (numTerritories + 1) * sizeof(std::uint32_t);
+    compiled.neighborIndices = reinterpret_cast<const std::uint32_t*>(cursor);
+    cursor += numBorders * sizeof(std::uint32_t);
+    compiled.stringPool = cursor;
+    compiled.numContinents = static_cast<size_t>(numContinents);
+    compiled.numTerritories = static_cast<size_t>(numTerritories);
+    compiled.numBorders = static_cast<size_t>(numBorders);
+    compiled.numChars = 0;
+
+    // Check every reference before touching the destination, so that a bad file can't leave it half filled
+    if (!compiled.check(header.stringPoolSize))
+    {
+        return false;
+    }
+
+    destination.build(compiled);
+
+    // Only valid maps get compiled
+    destination.validated = true;
+
+    // The map file was touched without being changed: record its new modification time, so that it isn't hashed again
+    if (sourceTouched)
+    {
+        compiledFile.close();
+        saveCompiled(compiledPath, source, destination);
+    }
+
+    return true;
+}
+
+bool MapLoader::saveCompiled(const std::string& compiledPath, const MappedFile& source, const Map& map) const
+{
+    std::string stringPool;
+
+    std::vector<CompiledContinent> compiledContinents;
+    compiledContinents.reserve(map.continents.size());
+    for (const Continent* const continent : map.continents)
+    {
+        CompiledContinent compiled;
+        compiled.nameOffset = addToStringPool(stringPool, continent->name, compiled.nameLength);
+        compiled.colorOffset = addToStringPool(stringPool, continent->color, compiled.colorLength);
+        compiled.bonus = continent->bonus;
+        compiledContinents.push_back(compiled);
+    }
+
+    std::vector<CompiledTerritory> compiledTerritories;
+    compiledTerritories.reserve(map.territories.size());
+    for (const Territory* const territory : map.territories)
+    {
+        CompiledTerritory compiled;
+        compiled.nameOffset = addToStringPool(stringPool, territory->name, compiled.nameLength);
+        compiled.continentID = territory->continentID;
+        compiled.x = territory->x;
+        compiled.y = territory->y;
+        compiledTerritories.push_back(compiled);
+    }
+
+    std::vector<char> buffer(sizeof(CompiledMapHeader));
+    appendBytes(buffer, compiledContinents.data(), compiledContinents.size());
+    appendBytes(buffer, compiledTerritories.data(), compiledTerritories.size());
+    const size_t numBorders = map.neighborOffsets[map.territories.size()];
+    appendBytes(buffer, map.neighborOffsets, map.territories.size() + 1);
+    appendBytes(buffer, map.neighborIndices, numBorders);
+    appendBytes(buffer, stringPool.data(), stringPool.size());
+
+    CompiledMapHeader header;
+    std::memcpy(header.magic, compiledMapMagic, sizeof(compiledMapMagic));
+    header.version = compiledMapVersion;
+    header.numContinents = static_cast<std::uint32_t>(map.continents.size());
+    header.numTerritories = static_cast<std::uint32_t>(map.territories.size());
+    header.numBorders = static_cast<std::uint32_t>(numBorders);
+    header.stringPoolSize = stringPool.size();
+    header.sourceSize = source.size();
+    header.sourceModificationTime = source.getModificationTime();
+    header.sourceHash = hashBytes(source.begin(), source.end());
+    std::memcpy(buffer.data(), &header, sizeof(header));
+
+    // Written under a temporary name then renamed, so that games loading the same map concurrently
+    // never see a partially written file
+    std::ostringstream temporaryPath;
+    temporaryPath << compiledPath << ".tmp" << std::hash<std::thread::id>()(std::this_thread::get_id());
+
+    {
+        std::ofstream outputFile(temporaryPath.str(), std::ios::binary | std::ios::trunc);
+        if (!outputFile.write(buffer.data(), buffer.size()))
+        {
+            outputFile.close();
+            std::remove(temporaryPath.str().c_str());
+            return false;
+        }
+    }
+
+    if (std::rename(temporaryPath.str().c_str(), compiledPath.c_str()) != 0)
+    {
+        // Some platforms don't replace existing files, drop the stale one and try again
+        std::remove(compiledPath.c_str());
+        if (std::rename(temporaryPath.str().c_str(), compiledPath.c_str()) != 0)
+        {
+            std::remove(temporaryPath.str().c_str());
+            return false;
+        }
+    }
+
+    return true;
+}
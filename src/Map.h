@@ -1,11 +1,78 @@
 #pragma once
+#include <cstdint>
 #include <iostream>
 #include <string>
-#include <vector>
 
 // Forward declarations to minimize dependencies
+class Continent;
+class MappedFile;
 class Player;
 class Territory;
+struct MapLayout;
+
+// Read-only view over a packed range of territory pointers
+// Points into the memory of a Map, and is only valid as long as the Map isn't modified
+class TerritorySpan
+{
+public:
+
+    // Default constructor (empty span)
+    TerritorySpan();
+    // Constructor with parameters
+    TerritorySpan(Territory* const* first, Territory* const* last);
+
+    // Iterators, for range-based for loops
+    Territory* const* begin() const;
+    Territory* const* end() const;
+
+    // Amount of territories in the span
+    size_t size() const;
+    // Checks if the span has no territories
+    bool empty() const;
+    // Returns the territory at the given position
+    Territory* operator [] (size_t position) const;
+    // Returns the first territory (the span must not be empty)
+    Territory* front() const;
+
+    // Stream output operator
+    friend std::ostream& operator << (std::ostream& out, const TerritorySpan& source);
+
+private:
+
+    Territory* const* first;
+    Territory* const* last;
+};
+
+// Read-only view over a packed range of continent pointers
+// Points into the memory of a Map, and is only valid as long as the Map isn't modified
+class ContinentSpan
+{
+public:
+
+    // Default constructor (empty span)
+    ContinentSpan();
+    // Constructor with parameters
+    ContinentSpan(Continent* const* first, Continent* const* last);
+
+    // Iterators, for range-based for loops
+    Continent* const* begin() const;
+    Continent* const* end() const;
+
+    // Amount of continents in the span
+    size_t size() const;
+    // Checks if the span has no continents
+    bool empty() const;
+    // Returns the continent at the given position
+    Continent* operator [] (size_t position) const;
+
+    // Stream output operator
+    friend std::ostream& operator << (std::ostream& out, const ContinentSpan& source);
+
+private:
+
+    Continent* const* first;
+    Continent* const* last;
+};
 
 // A connected sub-graph of territories
 // Does not own any memory itself, the Map class manages allocations instead
@@ -15,8 +82,8 @@ public:
 
     // Default constructor
     Continent();
-    // Constructor with parameters
-    Continent(int ID, const std::string& name, const std::string& color, int bonus);
+    // Constructor with parameters (the strings must outlive the continent)
+    Continent(int ID, const char* name, const char* color, int bonus);
     // Destructor
     ~Continent();
 
@@ -30,16 +97,45 @@ public:
     // Continent ID, as defined in the map file. Note: NOT 0-based
     int ID;
     // Continent name, as defined in the map file
-    std::string name;
+    const char* name;
     // Continent color, as defined in the map file
-    std::string color;
+    const char* color;
     // Continent army bonus, as defined in the map file
     int bonus;
 
     // Direct pointers to territories belonging to this continent
-    std::vector<Territory*> territories;
-    // IDs of the territories belonging to this continent
-    std::vector<int> territoryIDs;
+    TerritorySpan territories;
+};
+
+// Read-only view over a packed range of 0-based territory indices (index = territory ID - 1)
+// Points into the memory of a Map, and is only valid as long as the Map's graph isn't modified
+class TerritoryIndexSpan
+{
+public:
+
+    // Default constructor (empty span)
+    TerritoryIndexSpan();
+    // Constructor with parameters
+    TerritoryIndexSpan(const std::uint32_t* first, const std::uint32_t* last);
+
+    // Iterators, for range-based for loops
+    const std::uint32_t* begin() const;
+    const std::uint32_t* end() const;
+
+    // Amount of indices in the span
+    size_t size() const;
+    // Checks if the span has no indices
+    bool empty() const;
+    // Returns the index at the given position
+    std::uint32_t operator [] (size_t position) const;
+
+    // Stream output operator
+    friend std::ostream& operator << (std::ostream& out, const TerritoryIndexSpan& source);
+
+private:
+
+    const std::uint32_t* first;
+    const std::uint32_t* last;
 };
 
 // Represents a territory
@@ -50,8 +146,8 @@ public:
 
     // Default constructor
     Territory();
-    // Constructor with parameters
-    Territory(int ID, const std::string& name, Continent* const continent, int x, int y);
+    // Constructor with parameters (the name must outlive the territory)
+    Territory(int ID, const char* name, Continent* const continent, int x, int y);
     // Destructor
     ~Territory();
 
@@ -65,7 +161,7 @@ public:
     // Territory ID, as defined in the map file. Note: NOT 0 - based
     int ID;
     // Territory name, as defined in the map file
-    std::string name;
+    const char* name;
     // Direct pointer to the continent that this territory belongs to
     Continent* continent;
     // ID of the continent that this territory belongs to, as defined in the map file
@@ -74,15 +170,19 @@ public:
     int x;
     // Territory y position, as defined in the map file
     int y;
-    // Direct pointers to bordering territories
-    std::vector<Territory*> neighbors;
-    // IDs of bordering territories, as defined in the map file
-    std::vector<int> neighborIDs;
+    // Direct pointers to bordering territories, in map file order
+    // Kept for convenience, graph walks should prefer Map::getNeighborIndices
+    TerritorySpan neighbors;
+    // Direct pointers to territories that have this territory as a neighbor, in territory order
+    // (the reverse of neighbors, which only differs on maps with one-way borders)
+    TerritorySpan incomingNeighbors;
     // Check if a territory is in the list of neighbors
     bool isNeighbor(Territory* territory);
 
     // Direct pointer to the player who owns this territory
     Player* player;
+    // Position of this territory in its player's list of territories, kept up to date by Player
+    size_t playerSlot;
     // Number of the player's armies currently located inside this territory
     int armies;
 };
@@ -90,6 +190,8 @@ public:
 // Contains a map, as defined by a map file.
 // This class manages all allocations pertaining to continents and territories.
 // The lifetimes of a Map instance's continents and territories are tied to the instance.
+// Continents, territories, their names and borders all live in a single block of memory,
+// so copying a map is one allocation and destroying it is one deallocation.
 class Map
 {
     // MapLoader should have full access to this class
@@ -127,11 +229,17 @@ public:
     friend std::ostream& operator << (std::ostream &out, const Map& source);
 
     // Validates this map's graph connections
+    // (immediate for maps that MapLoader already validated)
     FormatError validate() const;
 
     // Releases all allocations pertaining to maps, continents, and territories
     void releaseAllocs();
 
+    // Makes this map a copy of the other one, like the assignment operator.
+    // When this map already is a copy of the same loaded map file, only the territories' owners and armies
+    // are copied, while its continents, territories and borders are kept as they are.
+    void assign(const Map& other);
+
     // Returns a pointer to a territory, given its ID
     // (nullptr if the ID is invalid)
     Continent* getContinentByID(int ID) const;
@@ -139,20 +247,50 @@ public:
     // (nullptr if the ID is invalid)
     Territory* getTerritoryByID(int ID) const;
 
+    // Returns the 0-based indices of the territories bordering a territory, given its 0-based index
+    // (index = ID - 1, same order as Territory::neighbors)
+    TerritoryIndexSpan getNeighborIndices(size_t territoryIndex) const;
+
     // The name of the map, determined from the filepath that MapLoader receives
     std::string name;
     // Continents in this map, ordered by ID
-    // NOTE: IDs are 1-based, so vector index = ID - 1
-    std::vector<Continent*> continents;
+    // NOTE: IDs are 1-based, so index = ID - 1
+    ContinentSpan continents;
     // Territories in this map, ordered by ID
-    // NOTE: IDs are 1-based, so vector index = ID - 1
-    std::vector<Territory*> territories;
+    // NOTE: IDs are 1-based, so index = ID - 1
+    TerritorySpan territories;
 
 private:
 
+    // Single block of memory holding, in order: continents, territories, the pointer arrays behind every span,
+    // the adjacency arrays and the names. Only the pointers to players leave it.
+    char* arena;
+    // Size of the arena, in bytes
+    size_t arenaSize;
+
+    // Compressed sparse row adjacency: the neighbors of territory i are
+    // neighborIndices[neighborOffsets[i]] to neighborIndices[neighborOffsets[i + 1] - 1]
+    const std::uint32_t* neighborOffsets;
+    // 0-based indices of all bordering territories, packed territory after territory
+    const std::uint32_t* neighborIndices;
+
+    // Set by MapLoader when the graph is known to be valid, so that validate doesn't need to walk it again
+    bool validated;
+
+    // Identifies the load that this map's graph comes from, shared by all copies of it (0 if not loaded)
+    std::uint64_t layoutID;
+
     // Calls releaseAllocs, then makes a full duplicate of the other map
     // (including its territories and continents)
     void deepCopy(const Map& other);
+
+    // Replaces the continents, territories and borders with the ones of a parsed or compiled map, packed into a new arena.
+    // Tables is MapLayout or CompiledMap (see Map.cpp).
+    template <typename Tables>
+    void build(const Tables& tables);
+
+    // Destroys the continents and territories, and frees the arena
+    void releaseArena();
 };
 
 // Loads map files from disk to populate Map instances
@@ -176,4 +314,29 @@ public:
     // Reports any errors using the return value and errorLine for the specific line of the
     // file where it occured.
     Map::FormatError load(const std::string& filepath, Map& destination, int& errorLine) const;
+
+    // Enables or disables the compiled map cache (enabled by default).
+    // When enabled, a map file that loads and validates successfully is also saved in a compact binary
+    // format next to it, and later loads of the unchanged file read the compiled map instead of parsing it.
+    void setCacheEnabled(bool enabled);
+    // Checks if the compiled map cache is enabled
+    bool isCacheEnabled() const;
+
+    // Returns the path of the compiled map cached for a map file (same path, .wzmap extension)
+    static std::string getCompiledPath(const std::string& filepath);
+
+private:
+
+    // Whether compiled maps are read and written
+    bool cacheEnabled;
+
+    // Parses the contents of a map file into a layout, that load then builds the destination Map from
+    Map::FormatError parse(const MappedFile& inputFile, MapLayout& layout, int& errorLine) const;
+
+    // Fills the destination Map from a compiled map, if there is one that was compiled from this exact source.
+    // Leaves the destination untouched and returns false otherwise.
+    bool loadCompiled(const std::string& compiledPath, const MappedFile& source, Map& destination) const;
+
+    // Saves a loaded and validated map in the compiled format
+    bool saveCompiled(const std::string& compiledPath, const MappedFile& source, const Map& map) const;
 };
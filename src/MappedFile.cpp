@@ -0,0 +1,221 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/* --- MappedFile --- */
+
+MappedFile::MappedFile():
+    filepath(),
+    data(nullptr),
+    length(0),
+    modificationTime(0),
+    opened(false)
+{
+
+}
+
+MappedFile::MappedFile(const MappedFile& other):
+    filepath(),
+    data(nullptr),
+    length(0),
+    modificationTime(0),
+    opened(false)
+{
+    if (other.opened)
+    {
+        open(other.filepath);
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+MappedFile& MappedFile::operator = (const MappedFile& other)
+{
+    if (this != &other)
+    {
+        close();
+        if (other.opened)
+        {
+            open(other.filepath);
+        }
+    }
+    return *this;
+}
+
+std::ostream& operator << (std::ostream& out, const MappedFile& source)
+{
+    out << source.filepath << " (" << source.length << " bytes)";
+    return out;
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& filepath)
+{
+    close();
+
+    HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize))
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    // Empty files can't be mapped, they simply have no contents
+    if (fileSize.QuadPart > 0)
+    {
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr)
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        // The view keeps the mapping alive, both handles can be closed right away
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        if (view == nullptr)
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        data = static_cast<const char*>(view);
+        length = static_cast<size_t>(fileSize.QuadPart);
+    }
+
+    // In 100 nanosecond ticks
+    FILETIME lastWriteTime;
+    if (GetFileTime(file, nullptr, nullptr, &lastWriteTime))
+    {
+        modificationTime = static_cast<std::int64_t>((static_cast<std::uint64_t>(lastWriteTime.dwHighDateTime) << 32) | lastWriteTime.dwLowDateTime);
+    }
+
+    CloseHandle(file);
+
+    this->filepath = filepath;
+    opened = true;
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (data != nullptr)
+    {
+        UnmapViewOfFile(data);
+    }
+
+    filepath.clear();
+    data = nullptr;
+    length = 0;
+    modificationTime = 0;
+    opened = false;
+}
+
+#else
+
+bool MappedFile::open(const std::string& filepath)
+{
+    close();
+
+    int file = ::open(filepath.c_str(), O_RDONLY);
+    if (file < 0)
+    {
+        return false;
+    }
+
+    struct stat status;
+    if (fstat(file, &status) != 0)
+    {
+        ::close(file);
+        return false;
+    }
+
+    // Empty files can't be mapped, they simply have no contents.
+    // Neither can directories or devices, which read as empty too.
+    if (S_ISREG(status.st_mode) && status.st_size > 0)
+    {
+        void* view = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+        if (view == MAP_FAILED)
+        {
+            ::close(file);
+            return false;
+        }
+
+        data = static_cast<const char*>(view);
+        length = static_cast<size_t>(status.st_size);
+    }
+
+    // In nanoseconds
+#ifdef __APPLE__
+    modificationTime = static_cast<std::int64_t>(status.st_mtimespec.tv_sec) * 1000000000 + status.st_mtimespec.tv_nsec;
+#else
+    modificationTime = static_cast<std::int64_t>(status.st_mtim.tv_sec) * 1000000000 + status.st_mtim.tv_nsec;
+#endif
+
+    // The mapping stays valid after the descriptor is closed
+    ::close(file);
+
+    this->filepath = filepath;
+    opened = true;
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (data != nullptr)
+    {
+        munmap(const_cast<char*>(data), length);
+    }
+
+    filepath.clear();
+    data = nullptr;
+    length = 0;
+    modificationTime = 0;
+    opened = false;
+}
+
+#endif
+
+bool MappedFile::isOpen() const
+{
+    return opened;
+}
+
+const char* MappedFile::begin() const
+{
+    return data;
+}
+
+const char* MappedFile::end() const
+{
+    return data + length;
+}
+
+size_t MappedFile::size() const
+{
+    return length;
+}
+
+std::int64_t MappedFile::getModificationTime() const
+{
+    return modificationTime;
+}
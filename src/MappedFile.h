@@ -0,0 +1,61 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// Read-only view over the whole contents of a file, mapped into memory instead of being copied.
+// The contents stay valid until the file is closed or the instance is destroyed.
+class MappedFile
+{
+public:
+
+    // Default constructor (no file)
+    MappedFile();
+    // Copy constructor (maps the same file again)
+    MappedFile(const MappedFile& other);
+    // Destructor
+    ~MappedFile();
+
+    // Assignment operator (maps the same file again)
+    MappedFile& operator = (const MappedFile& other);
+    // Stream output operator
+    friend std::ostream& operator << (std::ostream& out, const MappedFile& source);
+
+    // Maps a file into memory, closing any previously mapped file.
+    // Returns false if the file can't be opened.
+    bool open(const std::string& filepath);
+
+    // Unmaps the file
+    void close();
+
+    // Checks if a file is currently mapped
+    bool isOpen() const;
+
+    // Contents of the file. An empty file gives an empty range.
+    const char* begin() const;
+    const char* end() const;
+
+    // Size of the file, in bytes
+    size_t size() const;
+
+    // Time of the last modification of the file when it was mapped, in ticks of the platform's file times (0 if unknown)
+    std::int64_t getModificationTime() const;
+
+private:
+
+    // Path of the mapped file, empty if none
+    std::string filepath;
+
+    // First byte of the file contents, nullptr if the file is empty or not mapped
+    const char* data;
+
+    // Size of the file contents, in bytes
+    size_t length;
+
+    // Time of the last modification of the file, 0 if no file is mapped
+    std::int64_t modificationTime;
+
+    // Whether a file is currently mapped
+    bool opened;
+};
@@ -1,15 +1,28 @@
 #include "Orders.h"
+#include "GameContext.h"
 #include "Map.h"
 #include "Player.h"
 #include "PlayerStrategies.h"
 
 #include <algorithm>
 #include <sstream>
+#include <stdexcept>
 
-//==================== Order Class ====================
+// Records the capture of a continent in an order's effect, when the territory that a player just gained completes it
+static void recordContinentCapture(OrderEffect& effect, const Player& player, const Territory& territory)
+{
+    // Only the log needs it, headless builds skip the check
+    if (EventBus::enabled && player.controlsContinent(*territory.continent))
+    {
+        effect.capturingPlayer = &player;
+        effect.capturedContinent = territory.continent;
+    }
+}
+
+//==================== OrderData Struct ====================
 
-// Stream output operator of Order_Type
-std::ostream& operator << (std::ostream& out, const Order::Type source)
+// Stream output operator of OrderType
+std::ostream& operator << (std::ostream& out, const OrderType source)
 {
     // Names for the orders
     static const char* names[9] =
@@ -27,9 +40,597 @@ std::ostream& operator << (std::ostream& out, const Order::Type source)
     return out;
 }
 
+// Default Constructor
+OrderData::OrderData():
+    type(OrderType::Order),
+    cheat(false),
+    armies(0),
+    player(nullptr),
+    targetPlayer(nullptr),
+    sourceTerritory(nullptr),
+    targetTerritory(nullptr)
+{
+
+}
+
+// Deploy factory, the armies are taken from the reinforcement pool and placed on the territory right away
+OrderData OrderData::deploy(int armies, Player& player, Territory& territory)
+{
+    OrderData order;
+    order.type = OrderType::Deploy;
+    order.armies = armies;
+    order.player = &player;
+    order.targetTerritory = &territory;
+
+    player.setArmies(player.getArmies() - armies);
+    territory.armies += armies;
+    return order;
+}
+
+// Advance factory
+OrderData OrderData::advance(int armies, Player& player, Territory& sourceTerritory, Territory& targetTerritory, bool cheat)
+{
+    OrderData order;
+    order.type = OrderType::Advance;
+    order.cheat = cheat;
+    order.armies = armies;
+    order.player = &player;
+    order.sourceTerritory = &sourceTerritory;
+    order.targetTerritory = &targetTerritory;
+    return order;
+}
+
+// Bomb factory
+OrderData OrderData::bomb(Player& player, Territory& territory)
+{
+    OrderData order;
+    order.type = OrderType::Bomb;
+    order.player = &player;
+    order.targetTerritory = &territory;
+    return order;
+}
+
+// Blockade factory
+OrderData OrderData::blockade(Player& player, Player& neutralPlayer, Territory& territory)
+{
+    OrderData order;
+    order.type = OrderType::Blockade;
+    order.player = &player;
+    order.targetPlayer = &neutralPlayer;
+    order.targetTerritory = &territory;
+    return order;
+}
+
+// Airlift factory
+OrderData OrderData::airlift(int armies, Player& player, Territory& sourceTerritory, Territory& targetTerritory)
+{
+    OrderData order;
+    order.type = OrderType::Airlift;
+    order.armies = armies;
+    order.player = &player;
+    order.sourceTerritory = &sourceTerritory;
+    order.targetTerritory = &targetTerritory;
+    return order;
+}
+
+// Negotiate factory
+OrderData OrderData::negotiate(Player& player, Player& targetPlayer)
+{
+    OrderData order;
+    order.type = OrderType::Negotiate;
+    order.player = &player;
+    order.targetPlayer = &targetPlayer;
+    return order;
+}
+
+// Checks if this is an empty order
+bool OrderData::empty() const
+{
+    return type == OrderType::Order;
+}
+
+// Checks if a player can't attack the owner of a territory, because of a negotiation
+static bool isDiplomaticAlly(const Player& player, const Territory& territory)
+{
+    const vector<Player*>& unattackable = const_cast<Player&>(player).getUnattackable();
+    return std::find(unattackable.begin(), unattackable.end(), territory.player) != unattackable.end();
+}
+
+// Validate : checks if an order is valid
+bool OrderData::validate(OrderEffect& effect) const
+{
+    switch (type)
+    {
+        case OrderType::Deploy:
+        {
+            if (player == nullptr || targetTerritory == nullptr)
+            {
+                effect = OrderEffect::invalid("nullptr arguments passed");
+            }
+            else if (armies <= 0)
+            {
+                effect = OrderEffect::invalid("Not enough armies");
+            }
+            else if (!player->hasTerritory(targetTerritory))
+            {
+                effect = OrderEffect::invalid("Territory doesn't belong to player");
+            }
+            else
+            {
+                return true;
+            }
+            return false;
+        }
+        case OrderType::Advance:
+        {
+            if (player == nullptr || sourceTerritory == nullptr || targetTerritory == nullptr)
+            {
+                effect = OrderEffect::invalid("nullptr arguments passed");
+            }
+            else if (armies <= 0 || sourceTerritory->armies <= 0)
+            {
+                effect = OrderEffect::invalid("Not enough armies");
+            }
+            else if (isDiplomaticAlly(*player, *targetTerritory))
+            {
+                effect = OrderEffect::invalid("Can't attack diplomatic ally");
+            }
+            else if (!player->hasTerritory(sourceTerritory))
+            {
+                effect = OrderEffect::invalid("The source territory does not belong to the player that issued the order");
+            }
+            else if (!targetTerritory->isNeighbor(sourceTerritory) && !cheat)
+            {
+                effect = OrderEffect::invalid("The target territory is not adjacent to the source territory");
+            }
+            else
+            {
+                return true;
+            }
+            return false;
+        }
+        case OrderType::Bomb:
+        {
+            if (player == nullptr || targetTerritory == nullptr)
+            {
+                effect = OrderEffect::invalid("nullptr arguments passed");
+            }
+            else if (player == targetTerritory->player)
+            {
+                effect = OrderEffect::invalid("Can't bomb own territory");
+            }
+            else if (isDiplomaticAlly(*player, *targetTerritory))
+            {
+                effect = OrderEffect::invalid("Can't bomb a diplomatic ally");
+            }
+            else
+            {
+                // The target must be a neighbor of one of the player's territories
+                for (Territory* neighbor : targetTerritory->neighbors)
+                {
+                    if (neighbor->player == player)
+                    {
+                        return true;
+                    }
+                }
+
+                effect = OrderEffect::invalid("Can't bomb a territory that is not adjacent to an owned territory");
+            }
+            return false;
+        }
+        case OrderType::Blockade:
+        {
+            if (player == nullptr || targetPlayer == nullptr || targetTerritory == nullptr)
+            {
+                effect = OrderEffect::invalid("nullptr arguments passed");
+            }
+            else if (player != targetTerritory->player)
+            {
+                effect = OrderEffect::invalid("Can't blockade another player's territory");
+            }
+            else
+            {
+                return true;
+            }
+            return false;
+        }
+        case OrderType::Airlift:
+        {
+            if (player == nullptr || sourceTerritory == nullptr || targetTerritory == nullptr)
+            {
+                effect = OrderEffect::invalid("nullptr arguments passed");
+            }
+            else if (armies < 0)
+            {
+                effect = OrderEffect::invalid("Not enough armies");
+            }
+            else if (player != sourceTerritory->player)
+            {
+                effect = OrderEffect::invalid("Source territory doesn't belong to player");
+            }
+            else if (player != targetTerritory->player)
+            {
+                effect = OrderEffect::invalid("Target territory doesn't belong to player");
+            }
+            else
+            {
+                return true;
+            }
+            return false;
+        }
+        case OrderType::Negotiate:
+        {
+            if (player == nullptr || targetPlayer == nullptr)
+            {
+                effect = OrderEffect::invalid("nullptr arguments passed");
+            }
+            else if (player == targetPlayer)
+            {
+                effect = OrderEffect::invalid("Can't negotiate with oneself");
+            }
+            else
+            {
+                return true;
+            }
+            return false;
+        }
+        case OrderType::Order:
+        {
+            break;
+        }
+    }
+
+    return true;
+}
+
+// Takes a territory from its owner and gives it to a player who conquered it.
+// If the territory belonged to a neutral player, the neutral player becomes aggressive.
+static void conquer(Player& player, Territory& territory)
+{
+    NeutralPlayerStrategy* neutralStrategy = dynamic_cast<NeutralPlayerStrategy*>(&territory.player->getPlayerStrategy());
+    if (neutralStrategy != nullptr) {
+        neutralStrategy->becomeAggressive();
+    }
+
+    territory.player->removeTerritory(&territory);
+    player.addTerritory(&territory);
+
+    // GameEngine will give this player a card and reset this flag to false
+    // before the start of the next turn
+    player.hasConqueredThisTurn = true;
+}
+
+//Execute : First validates the order, and if valid executes its action
+bool OrderData::execute(GameContext& context, OrderEffect& effect)
+{
+    if (!validate(effect))
+    {
+        // Deployed armies go back to the reinforcement pool
+        if (type == OrderType::Deploy && player != nullptr && targetTerritory != nullptr)
+        {
+            player->setArmies(player->getArmies() + armies);
+            targetTerritory->armies += armies;
+        }
+        return false;
+    }
+
+    effect = OrderEffect();
+
+    switch (type)
+    {
+        case OrderType::Deploy:
+        {
+            effect.kind = OrderEffect::Kind::Deployed;
+            break;
+        }
+        case OrderType::Advance:
+        {
+            if (cheat)
+            {
+                // Player is cheating and will conquer the territory regardless of the game rules
+                targetTerritory->armies = 0;
+                conquer(*player, *targetTerritory);
+
+                effect.kind = OrderEffect::Kind::Cheated;
+                recordContinentCapture(effect, *player, *targetTerritory);
+            }
+            // If the source and target territories both belong to the player, then we just move the armies there
+            else if (player->hasTerritory(sourceTerritory) && player->hasTerritory(targetTerritory))
+            {
+                sourceTerritory->armies -= armies;
+                targetTerritory->armies += armies;
+
+                effect.kind = OrderEffect::Kind::Moved;
+            }
+            // If the target territory does not belong to the player, then we attack.
+            else if (!player->hasTerritory(targetTerritory))
+            {
+                int armiesAttacking = armies;
+                int armiesDefending = targetTerritory->armies;
+
+                // If the territory that we are attacking belongs to a neutral player, then we make the neutral player aggressive
+                NeutralPlayerStrategy* neutralStrategy = dynamic_cast<NeutralPlayerStrategy*>(&targetTerritory->player->getPlayerStrategy());
+                if (neutralStrategy != nullptr) {
+                    neutralStrategy->becomeAggressive();
+                }
+
+                // Each attacking army has a 60% chance of killing a defending army,
+                // and each defending army has a 70% chance of killing an attacking army
+                Random& random = context.getRandom();
+                int armiesDefendingKilled = random.nextBinomial(armiesAttacking, 0.6);
+                int armiesAttackingKilled = random.nextBinomial(armiesDefending, 0.7);
+
+                int armiesAttackingLeft = max(0, armiesAttacking - armiesAttackingKilled);
+                int armiesDefendingLeft = max(0, armiesDefending - armiesDefendingKilled);
+
+                effect.attackersLeft = armiesAttackingLeft;
+                effect.defendersLeft = armiesDefendingLeft;
+
+                if (armiesDefendingLeft <= 0)
+                {
+                    sourceTerritory->armies -= armiesAttacking;
+                    targetTerritory->armies = armiesAttackingLeft;
+                    conquer(*player, *targetTerritory);
+
+                    effect.kind = OrderEffect::Kind::Conquered;
+                    recordContinentCapture(effect, *player, *targetTerritory);
+                }
+                else
+                {
+                    sourceTerritory->armies -= armiesAttackingKilled;
+                    targetTerritory->armies = armiesDefendingLeft;
+
+                    effect.kind = OrderEffect::Kind::Attacked;
+                }
+            }
+            break;
+        }
+        case OrderType::Bomb:
+        {
+            effect.armiesBefore = targetTerritory->armies;
+            targetTerritory->armies /= 2;
+            effect.armiesAfter = targetTerritory->armies;
+
+            effect.kind = OrderEffect::Kind::Bombed;
+            break;
+        }
+        case OrderType::Blockade:
+        {
+            effect.armiesBefore = targetTerritory->armies;
+            targetTerritory->armies *= 2;
+            effect.armiesAfter = targetTerritory->armies;
+            targetTerritory->player->removeTerritory(targetTerritory);
+            targetPlayer->addTerritory(targetTerritory);
+
+            effect.kind = OrderEffect::Kind::Blockaded;
+            recordContinentCapture(effect, *targetPlayer, *targetTerritory);
+            break;
+        }
+        case OrderType::Airlift:
+        {
+            sourceTerritory->armies -= armies;
+            targetTerritory->armies += armies;
+
+            effect.kind = OrderEffect::Kind::Airlifted;
+            break;
+        }
+        case OrderType::Negotiate:
+        {
+            player->setUnattackable(targetPlayer);
+            targetPlayer->setUnattackable(player);
+
+            effect.kind = OrderEffect::Kind::Negotiated;
+            break;
+        }
+        case OrderType::Order:
+        {
+            break;
+        }
+    }
+
+    return true;
+}
+
+// Print method to display the description and effect of the order
+ostream& OrderData::print(ostream& out, bool executed, const OrderEffect& effect) const
+{
+    if (type == OrderType::Order)
+    {
+        return out << "Order type: " << type << endl;
+    }
+
+    if (player == nullptr)
+    {
+        out << "[" << type << " | nullptr]";
+    }
+    else
+    {
+        out << "[" << type << " | " << player->getName() << "]";
+    }
+    if (executed)
+    {
+        out << " executed";
+    }
+    if (!effect.empty())
+    {
+        out << ": ";
+        effect.print(out, *this);
+    }
+    return out;
+}
+
+
+
+//==================== OrderEffect Struct ====================
+
+// Default Constructor
+OrderEffect::OrderEffect():
+    kind(Kind::None),
+    reason(nullptr),
+    armiesBefore(0),
+    armiesAfter(0),
+    attackersLeft(0),
+    defendersLeft(0),
+    capturingPlayer(nullptr),
+    capturedContinent(nullptr)
+{
+
+}
+
+// Outcome of an order that was just issued.
+// Bomb and Blockade describe the target's armies, which can change before the description is printed.
+OrderEffect OrderEffect::issued(const OrderData& order)
+{
+    OrderEffect effect;
+    effect.kind = Kind::Issued;
+    if (order.targetTerritory != nullptr)
+    {
+        effect.armiesBefore = order.targetTerritory->armies;
+    }
+    return effect;
+}
+
+// Outcome of an order that didn't pass validation (the reason must outlive the effect)
+OrderEffect OrderEffect::invalid(const char* reason)
+{
+    OrderEffect effect;
+    effect.kind = Kind::Invalid;
+    effect.reason = reason;
+    return effect;
+}
+
+// Checks if nothing was recorded
+bool OrderEffect::empty() const
+{
+    return kind == Kind::None;
+}
+
+// Prints what the order will do when it was issued, or what it did once executed
+ostream& OrderEffect::print(ostream& out, const OrderData& order) const
+{
+    const Territory* source = order.sourceTerritory;
+    const Territory* target = order.targetTerritory;
+
+    switch (kind)
+    {
+        case Kind::None:
+        {
+            return out;
+        }
+        case Kind::Issued:
+        {
+            switch (order.type)
+            {
+                case OrderType::Deploy:
+                {
+                    return out << "Will deploy " << order.armies << " armies on territory " << target->name;
+                }
+                case OrderType::Advance:
+                {
+                    return out << "Will advance " << order.armies << " armies from territory " << source->name << " to territory " << target->name;
+                }
+                case OrderType::Bomb:
+                {
+                    return out << "Will bomb territory " << target->name << ". It has " << armiesBefore << " armies.";
+                }
+                case OrderType::Blockade:
+                {
+                    return out << "Will blockade territory " << target->name << ". It has " << armiesBefore << " armies.";
+                }
+                case OrderType::Airlift:
+                {
+                    return out << "Will airlift " << order.armies << " armies from territory " << source->name << " to " << target->name;
+                }
+                case OrderType::Negotiate:
+                {
+                    return out << order.targetPlayer->getName() << " will be a diplomatic ally for this turn.";
+                }
+                case OrderType::Order:
+                {
+                    return out;
+                }
+            }
+            return out;
+        }
+        case Kind::Invalid:
+        {
+            return out << reason;
+        }
+        case Kind::Deployed:
+        {
+            return out << "Deployed " << order.armies << " armies on territory " << target->name;
+        }
+        case Kind::Moved:
+        {
+            return out << "Advanced " << order.armies << " armies from territory " << source->name << " to territory " << target->name;
+        }
+        case Kind::Attacked:
+        {
+            return out << "Attacked from territory " << source->name << " to " << target->name <<
+                   " with " << order.armies << " armies. " << attackersLeft << " attacking armies are left and "
+                   << defendersLeft << " defending armies are left.";
+        }
+        case Kind::Conquered:
+        {
+            out << "Attacked from territory " << source->name << " to " << target->name <<
+                " with " << order.armies << " armies. The territory was conquered. " << attackersLeft
+                << " attacking armies are left and have occupied the territory.";
+            break;
+        }
+        case Kind::Cheated:
+        {
+            out << order.player->getName() << " is cheating and has conquered " << target->name << " regardless of the game rules.";
+            break;
+        }
+        case Kind::Bombed:
+        {
+            return out << "Bombed territory " << target->name << ". It had " << armiesBefore << " armies, now " << armiesAfter << " are left.";
+        }
+        case Kind::Blockaded:
+        {
+            out << "Blockaded territory " << target->name << ". It had " << armiesBefore << " armies, now it has " << armiesAfter << ".";
+            break;
+        }
+        case Kind::Airlifted:
+        {
+            return out << "Airlifted " << order.armies << " armies from territory " << source->name << " to " << target->name;
+        }
+        case Kind::Negotiated:
+        {
+            return out << order.targetPlayer->getName() << " is a diplomatic ally for this turn.";
+        }
+    }
+
+    // Orders that change a territory's owner can complete a continent
+    if (capturedContinent != nullptr)
+    {
+        out << " " << capturingPlayer->getName() << " captured the continent " << capturedContinent->name << ".";
+    }
+    return out;
+}
+
+
+
+//==================== OrderEvent Struct ====================
+
+// Prints the event as it is logged
+ostream& OrderEvent::print(ostream& out) const
+{
+    if (added)
+    {
+        // Same as the log of the added order, with its description as the effect
+        out << "OrdersList new element: ";
+    }
+    return order.print(out, executed, effect);
+}
+
+
+
+//==================== Order Class ====================
+
 // Default Constructor
 Order::Order():
-    orderType(Type::Order),
+    data(),
     executed(false),
     effect()
 {
@@ -38,7 +639,7 @@ Order::Order():
 
 // Copy Constructor
 Order::Order(const Order& copy):
-    orderType(copy.orderType),
+    data(copy.data),
     executed(copy.executed),
     effect(copy.effect)
 {
@@ -46,32 +647,45 @@ Order::Order(const Order& copy):
 
 // Parameterized Constructor
 Order::Order(const Type orderType):
-    orderType(orderType),
+    data(),
     executed(false),
     effect()
 {
+    data.type = orderType;
+}
+
+// Parameterized Constructor
+Order::Order(const OrderData& data):
+    data(data),
+    executed(false),
+    effect(OrderEffect::issued(data))
+{
 
 }
 
 // Getter for the order type
 Order::Type Order::getType() const
 {
-    return orderType;
+    return data.type;
+}
+
+// Getter for the encoded order
+const OrderData& Order::getData() const
+{
+    return data;
 }
 
 // Setter for the order type
 void Order::setType(Type orderType)
 {
-    this->orderType = orderType;
+    data.type = orderType;
 }
 
 // Setter the execution effect
-void Order::saveEffect(const std::string& effect, bool executed)
+void Order::saveEffect(const OrderEffect& effect, bool executed)
 {
     this->effect = effect;
     this->executed = executed;
-    // Notify the observers that the Order object has changed
-    notify();
 }
 
 // Destructor
@@ -89,22 +703,41 @@ ostream& operator << (ostream& out, const Order& order)
 // Assignment Operator
 Order& Order::operator = (const Order& order)
 {
-    this->orderType = order.orderType;
+    this->data = order.data;
     this->executed = order.executed;
     this->effect = order.effect;
     return *this;
 }
 
+// Execute : First validates the order, and if valid executes its action
+bool Order::execute(GameContext& context)
+{
+    OrderEffect result;
+    bool valid = data.execute(context, result);
+    saveEffect(result, valid);
+
+    // Publish that an order was executed
+    EventBus::publish(OrderEvent{ data, false, valid, effect });
+    return valid;
+}
+
 // Validate method
 bool Order::validate()
 {
-    return true;
+    OrderEffect result;
+    if (data.validate(result))
+    {
+        return true;
+    }
+
+    saveEffect(result, false);
+    return false;
 }
 
-//Print the order type
+//Print the order type, description and effect
 ostream& Order::print(ostream& out) const
 {
-    return out << "Order type: " << getType() << endl;
+    return data.print(out, executed, effect);
 }
 
 // Getter for bool executed
@@ -113,480 +746,462 @@ bool Order::getExecuted() const
     return this->executed;
 }
 
-string Order::stringToLog()
+
+
+//==================== OrderList Class ====================
+
+// Iterator Parameterized Constructor
+OrdersList::Iterator::Iterator(const OrdersList& ordersList, size_t position):
+    ordersList(&ordersList),
+    position(position)
 {
-    std::ostringstream stream;
-    print(stream);
-    return stream.str();
+
 }
 
+// Returns the current order
+const OrderData& OrdersList::Iterator::operator * () const
+{
+    return ordersList->slot(position);
+}
 
+// Moves to the next order
+OrdersList::Iterator& OrdersList::Iterator::operator ++ ()
+{
+    position++;
+    return *this;
+}
 
-//==================== OrderList Class ====================
+// Iterator equality operators
+bool OrdersList::Iterator::operator == (const Iterator& other) const
+{
+    return ordersList == other.ordersList && position == other.position;
+}
+
+bool OrdersList::Iterator::operator != (const Iterator& other) const
+{
+    return !(*this == other);
+}
 
 //Default Constructor
 OrdersList::OrdersList():
-    orderList()
+    slots(),
+    head(0),
+    count(0)
 {
 
 }
 
 // Copy Constructor
-OrdersList::OrdersList(const OrdersList& other)
+OrdersList::OrdersList(const OrdersList& other):
+    slots(),
+    head(0),
+    count(0)
 {
-    deepCopy(other.orderList);
+    reserve(other.count);
+    for (const OrderData& order : other)
+    {
+        slot(count++) = order;
+    }
 }
 
 // Parameterized Constructor
-OrdersList::OrdersList(const vector<Order*>& orderList)
+OrdersList::OrdersList(const vector<Order*>& orderList):
+    slots(),
+    head(0),
+    count(0)
 {
-    deepCopy(orderList);
+    reserve(orderList.size());
+    for (const Order* order : orderList)
+    {
+        if (!order->getData().empty())
+        {
+            slot(count++) = order->getData();
+        }
+    }
 }
 
 // Destructor
 OrdersList::~OrdersList()
 {
-    for (Order* order : orderList)
-    {
-        delete order;
-    }
+
 }
 
 // Removes an order from the specified index
 void OrdersList::remove(int index)
 {
-    Order* order = orderList.at(index);
-    orderList.erase(orderList.begin() + index);
-    delete order;
+    if (index < 0 || static_cast<size_t>(index) >= count)
+    {
+        throw std::out_of_range("OrdersList::remove");
+    }
+
+    if (index == 0)
+    {
+        removeFront();
+        return;
+    }
+
+    // Close the gap by shifting the following orders
+    for (size_t i = index; i + 1 < count; ++i)
+    {
+        slot(i) = slot(i + 1);
+    }
+    count--;
+}
+
+// Removes the first order, by moving the start of the ring buffer past it
+void OrdersList::removeFront()
+{
+    head = (head + 1) & (slots.size() - 1);
+    count--;
+    if (count == 0)
+    {
+        head = 0;
+    }
+}
+
+// Executes the first order, then removes it
+bool OrdersList::executeFront(GameContext& context)
+{
+    OrderData order = slot(0);
+    OrderEffect effect;
+    bool executed = order.execute(context, effect);
+    removeFront();
+
+    // Publish that an order was executed
+    EventBus::publish(OrderEvent{ order, false, executed, effect });
+    return executed;
 }
 
 // Move the order from index x (from) to index y (to)
 void OrdersList::move(int from, int to)
 {
-    std::swap(orderList[from], orderList[to]);
+    std::swap(slot(from), slot(to));
 }
 
 // Add an order to the orders list
-void OrdersList::addOrder(Order *order)
+void OrdersList::addOrder(const OrderData& order)
 {
-    // Attach our observers
-    for (Observer* observer : observers)
+    if (count == slots.size())
+    {
+        grow(max<size_t>(8, slots.size() * 2));
+    }
+
+    slot(count++) = order;
+
+    // Publish that an order was added, describing it only if someone receives it
+    if (EventBus::hasSubscribers<OrderEvent>())
+    {
+        OrderEffect effect = OrderEffect::issued(order);
+        EventBus::publish(OrderEvent{ order, true, false, effect });
+    }
+}
+
+// Adds an order which was issued earlier, publishing the description it had back then
+void OrdersList::addOrder(const OrderData& order, const OrderEffect& issued)
+{
+    if (count == slots.size())
+    {
+        grow(max<size_t>(8, slots.size() * 2));
+    }
+
+    slot(count++) = order;
+
+    if (EventBus::hasSubscribers<OrderEvent>())
     {
-        order->attach(*observer);
+        EventBus::publish(OrderEvent{ order, true, false, issued });
     }
+}
 
-    orderList.push_back(order);
-    // Notify the observers that an order of type etc etc was added to an orderList
-    notify();
+// Add an order object to the orders list, which only keeps its encoded order
+void OrdersList::addOrder(Order* order)
+{
+    addOrder(order->getData());
+    delete order;
+}
+
+// Makes room for a number of orders
+void OrdersList::reserve(size_t capacity)
+{
+    if (capacity > slots.size())
+    {
+        size_t newCapacity = max<size_t>(8, slots.size());
+        while (newCapacity < capacity)
+        {
+            newCapacity *= 2;
+        }
+        grow(newCapacity);
+    }
 }
 
 // Assignment operator
 OrdersList& OrdersList::operator = (const OrdersList& other)
 {
-    for (const Order* order : orderList)
+    if (this != &other)
     {
-        delete order;
+        head = 0;
+        count = 0;
+        reserve(other.count);
+        for (const OrderData& order : other)
+        {
+            slot(count++) = order;
+        }
     }
 
-    deepCopy(other.orderList);
-
     return *this;
 }
 
 // Stream insertion operator
 ostream& operator << (ostream& out, const OrdersList& source)
 {
-    for (size_t i = 0; i < source.orderList.size(); i++)
+    for (size_t i = 0; i < source.size(); i++)
     {
-        out << "[Order " + to_string(i) << "] " << source.getOrdersList()[i]->getType() << endl;
+        out << "[Order " + to_string(i) << "] " << source.at(i).type << endl;
     }
     return out;
 }
 
-// Getter for orderList
-vector<Order *>& OrdersList::getOrdersList()
+// Getter for the number of orders
+size_t OrdersList::size() const
 {
-    return orderList;
+    return count;
 }
 
-// Const getter for orderList
-const vector<Order *>& OrdersList::getOrdersList() const
+// Checks if there are no orders
+bool OrdersList::empty() const
 {
-    return orderList;
+    return count == 0;
 }
 
-// Method to deep copy the order list
-void OrdersList::deepCopy(const vector<Order*>& orderList)
+// Getter for the order at an index
+const OrderData& OrdersList::at(size_t index) const
 {
-    for (const Order* order : orderList)
+    if (index >= count)
     {
-        switch (order->getType())
-        {
-            case (Order::Type::Deploy):
-            {
-                this->orderList.push_back(new Deploy(*static_cast<const Deploy*>(order)));
-                break;
-            }
-            case (Order::Type::Advance):
-            {
-                this->orderList.push_back(new Advance(*static_cast<const Advance*>(order)));
-                break;
-            }
-            case (Order::Type::Bomb):
-            {
-                this->orderList.push_back(new Bomb(*static_cast<const Bomb*>(order)));
-                break;
-            }
-            case (Order::Type::Blockade):
-            {
-                this->orderList.push_back(new Blockade(*static_cast<const Blockade*>(order)));
-                break;
-            }
-            case (Order::Type::Airlift):
-            {
-                this->orderList.push_back(new Airlift(*static_cast<const Airlift*>(order)));
-                break;
-            }
-            case (Order::Type::Negotiate):
-            {
-                this->orderList.push_back(new Negotiate(*static_cast<const Negotiate*>(order)));
-                break;
-            }
-            case (Order::Type::Order):
-            {
-                break;
-            }
-        }
+        throw std::out_of_range("OrdersList::at");
     }
+
+    return slot(index);
 }
 
-string OrdersList::stringToLog()
+// Getter for the first order
+const OrderData& OrdersList::front() const
 {
-    Order* lastOrder = orderList.back();
-
-    std::ostringstream stream;
-    stream << "OrdersList new element: " << lastOrder->stringToLog();
-    return stream.str();
+    return slot(0);
 }
 
+// Getter for the last order
+const OrderData& OrdersList::back() const
+{
+    return slot(count - 1);
+}
 
+// Iterators
+OrdersList::Iterator OrdersList::begin() const
+{
+    return Iterator(*this, 0);
+}
 
-//==================== Deploy Class ====================
+OrdersList::Iterator OrdersList::end() const
+{
+    return Iterator(*this, count);
+}
 
-// Default Constructor
-Deploy::Deploy():
-    Order(),
-    armies(0),
-    player(nullptr),
-    territory(nullptr)
+// The capacity is a power of 2, so wrapping around is a mask
+OrderData& OrdersList::slot(size_t index)
 {
-    this->setType(Type::Deploy);
+    return slots[(head + index) & (slots.size() - 1)];
 }
 
-// Copy Constructor
-Deploy::Deploy(const Deploy& source):
-    Order(source),
-    armies(source.armies),
-    player(source.player),
-    territory(source.territory)
+const OrderData& OrdersList::slot(size_t index) const
 {
-    this->setType(Type::Deploy);
+    return slots[(head + index) & (slots.size() - 1)];
 }
 
-// Parameterized Constructor
-Deploy::Deploy(int armies, Player& player, Territory& territory):
-    Order(),
-    armies(armies),
-    player(&player),
-    territory(&territory)
+// Moves the orders to a new ring buffer, in order from slot 0
+void OrdersList::grow(size_t capacity)
 {
-    this->setType(Type::Deploy);
-    player.setArmies(player.getArmies() - armies);
-    territory.armies += armies;
+    vector<OrderData> newSlots(capacity);
+    for (size_t i = 0; i < count; ++i)
+    {
+        newSlots[i] = slot(i);
+    }
 
-    std::ostringstream stream;
-    stream << "Will deploy " << armies << " armies on territory " << territory.name;
-    effect = stream.str();
+    slots.swap(newSlots);
+    head = 0;
 }
 
-// Destructor
-Deploy::~Deploy()
+
+
+//==================== OrderSink Class ====================
+
+//Default Constructor
+OrderSink::OrderSink():
+    orders(),
+    effects(),
+    passed(false)
 {
 
 }
 
-// Execute : First validates the order, and if valid executes its action
-bool Deploy::execute()
+// Copy Constructor
+OrderSink::OrderSink(const OrderSink& other):
+    orders(other.orders),
+    effects(other.effects),
+    passed(other.passed)
 {
-    if (validate())
-    {
-        std::ostringstream stream;
-        stream << "Deployed " << armies << " armies on territory " << territory->name;
-        saveEffect(stream.str());
 
-        return true;
-    }
-    else
-    {
-        player->setArmies(player->getArmies() + armies);
-        territory->armies += armies;
-        return false;
-    }
 }
 
-// Validate : checks if an order is valid
-bool Deploy::validate()
+// Destructor
+OrderSink::~OrderSink()
 {
-    if (player == nullptr || territory == nullptr)
-    {
-        saveEffect("nullptr arguments passed", false);
-    }
-    else if (armies <= 0)
-    {
-        saveEffect("Not enough armies", false);
-    }
-    else if (!player->hasTerritory(territory))
-    {
-        saveEffect("Territory doesn't belong to player", false);
-    }
-    else
-    {
-        return true;
-    }
 
-    return false;
 }
 
 // Assignment operator
-Deploy& Deploy::operator = (const Deploy& other)
+OrderSink& OrderSink::operator = (const OrderSink& other)
 {
-    Order::operator = (other);
-    armies = other.armies;
-    player = other.player;
-    territory = other.territory;
+    orders = other.orders;
+    effects = other.effects;
+    passed = other.passed;
     return *this;
 }
 
-// Stream operator that calls the print
-ostream& operator<<(ostream& out, const Deploy& source)
-{
-    return source.print(out);
-}
-
-// Print method to display the description and effect of the order
-ostream& Deploy::print(ostream& out) const
+// Stream insertion operator
+ostream& operator << (ostream& out, const OrderSink& source)
 {
-    std::string playerName = player == nullptr ? "nullptr" : player->getName();
-    out << "[" << getType() << " | " << playerName << "]";
-    if (executed)
+    for (size_t i = 0; i < source.size(); i++)
     {
-        out << " executed";
-    }
-    if (effect.size() > 0)
-    {
-        out << ": " << effect;
+        out << "[Order " + to_string(i) << "] " << source.at(i).type << endl;
     }
     return out;
 }
 
+// Add an order after the ones already issued
+void OrderSink::add(const OrderData& order)
+{
+    orders.push_back(order);
+    effects.push_back(OrderEffect::issued(order));
+}
 
+// Records that the player passed the round after its last order
+void OrderSink::pass()
+{
+    passed = true;
+}
 
+// Getter for whether the player passed the round after its last order
+bool OrderSink::hasPassed() const
+{
+    return passed;
+}
 
-// ==================== Advance Class ====================
-
-// Default Constructor
-Advance::Advance():
-    Order(),
-    armies(0),
-    player(nullptr),
-    sourceTerritory(nullptr),
-    targetTerritory(nullptr),
-    cheat(false)
+// Forgets the orders, the vector keeps its capacity
+void OrderSink::clear()
 {
-    this->setType(Type::Advance);
+    orders.clear();
+    effects.clear();
+    passed = false;
 }
 
-// Copy Constructor
-Advance::Advance(const Advance &other):
-    Order(other),
-    armies(other.armies),
-    player(other.player),
-    sourceTerritory(other.sourceTerritory),
-    targetTerritory(other.targetTerritory),
-    cheat(other.cheat)
+// Getter for the number of orders
+size_t OrderSink::size() const
 {
-    this->setType(Type::Advance);
+    return orders.size();
 }
 
-// Parameterized Constructor
-Advance::Advance(int armies, Player& player, Territory& sourceTerritory, Territory& targetTerritory, bool cheat):
-    Order(),
-    armies(armies),
-    player(&player),
-    sourceTerritory(&sourceTerritory),
-    targetTerritory(&targetTerritory),
-    cheat(cheat)
+// Getter for the order at an index
+const OrderData& OrderSink::at(size_t index) const
 {
-    this->setType(Type::Advance);
+    return orders.at(index);
+}
 
-    std::ostringstream stream;
-    stream << "Will advance " << armies << " armies from territory " << sourceTerritory.name << " to territory " << targetTerritory.name;
-    effect = stream.str();
+// Getter for the description of the order at an index
+const OrderEffect& OrderSink::effectAt(size_t index) const
+{
+    return effects.at(index);
 }
 
-// Destructor
-Advance::~Advance()
+
+
+//==================== Deploy Class ====================
+
+// Default Constructor
+Deploy::Deploy():
+    Order(Type::Deploy)
 {
 
 }
 
-float random01()
+// Copy Constructor
+Deploy::Deploy(const Deploy& source):
+    Order(source)
 {
-    return static_cast<float>(rand()) / static_cast<float>(RAND_MAX);
+
 }
 
-//Execute : First validates the order, and if valid executes its action
-bool Advance::execute()
+// Parameterized Constructor
+Deploy::Deploy(int armies, Player& player, Territory& territory):
+    Order(OrderData::deploy(armies, player, territory))
 {
-    if (validate())
-    {
-        if (!cheat) {
-            // If the source and target territories both belong to the player, then we just move the armies there
-            if (player->hasTerritory(sourceTerritory) && player->hasTerritory(targetTerritory)) {
-                sourceTerritory->armies -= this->armies; // Move the number of armies to the target territory
-                targetTerritory->armies += this->armies;
-
-                std::ostringstream stream;
-                stream << "Advanced " << armies << " armies from territory " << sourceTerritory->name
-                       << " to territory " << targetTerritory->name;
-                saveEffect(stream.str());
-            }
-                // If the target territory does not belong to the player, then we attack.
-            else if (!player->hasTerritory(targetTerritory)) {
 
-                // If the territory that we are attacking belongs to a neutral player, then we make the neutral player aggressive
-                NeutralPlayerStrategy* neutralStrategy = dynamic_cast<NeutralPlayerStrategy*>(&targetTerritory->player->getPlayerStrategy());
-                if (neutralStrategy != nullptr) {
-                    neutralStrategy->becomeAggressive();
-                }
+}
 
-                int armiesAttacking = armies;
-                int armiesDefending = targetTerritory->armies;
+// Destructor
+Deploy::~Deploy()
+{
 
-                int armiesDefendingKilled = 0;
-                for (int i = 0; i < armiesAttacking; ++i) {
-                    if (random01() <= 0.6f) {
-                        armiesDefendingKilled++;
-                    }
-                }
+}
 
-                int armiesAttackingKilled = 0;
-                for (int i = 0; i < armiesDefending; ++i) {
-                    if (random01() <= 0.7f) {
-                        armiesAttackingKilled++;
-                    }
-                }
+// Assignment operator
+Deploy& Deploy::operator = (const Deploy& other)
+{
+    Order::operator = (other);
+    return *this;
+}
 
-                int armiesAttackingLeft = max(0, armiesAttacking - armiesAttackingKilled);
-                int armiesDefendingLeft = max(0, armiesDefending - armiesDefendingKilled);
+// Stream operator that calls the print
+ostream& operator<<(ostream& out, const Deploy& source)
+{
+    return source.print(out);
+}
 
-                if (armiesDefendingLeft <= 0) {
-                    sourceTerritory->armies -= armiesAttacking;
-                    targetTerritory->armies = armiesAttackingLeft;
 
-                    targetTerritory->player->removeTerritory(targetTerritory);
-                    player->addTerritory(targetTerritory);
-                    targetTerritory->player = player;
 
-                    std::ostringstream stream;
-                    stream << "Attacked from territory " << sourceTerritory->name << " to " << targetTerritory->name <<
-                           " with " << armies << " armies. The territory was conquered. " << armiesAttackingLeft
-                           << " attacking armies are left and have occupied the territory.";
-                    saveEffect(stream.str());
 
-                    // GameEngine will give this player a card and reset this flag to false
-                    // before the start of the next turn
-                    player->hasConqueredThisTurn = true;
-                } else {
-                    sourceTerritory->armies -= armiesAttackingKilled;
-                    targetTerritory->armies = armiesDefendingLeft;
+// ==================== Advance Class ====================
 
-                    std::ostringstream stream;
-                    stream << "Attacked from territory " << sourceTerritory->name << " to " << targetTerritory->name <<
-                           " with " << armies << " armies. " << armiesAttackingLeft << " attacking armies are left and "
-                           << armiesDefendingLeft << " defending armies are left.";
-                    saveEffect(stream.str());
-                }
-            }
-            // Player is cheating and will conquer the territory regardless of the game rules
-        } else {
-            // If the territory that we are attacking belongs to a neutral player, then we make the neutral player aggressive
-            NeutralPlayerStrategy* neutralStrategy = dynamic_cast<NeutralPlayerStrategy*>(&targetTerritory->player->getPlayerStrategy());
-            if (neutralStrategy != nullptr) {
-                neutralStrategy->becomeAggressive();
-            }
+// Default Constructor
+Advance::Advance():
+    Order(Type::Advance)
+{
 
-            targetTerritory->armies = 0;
-            targetTerritory->player->removeTerritory(targetTerritory);
-            player->addTerritory(targetTerritory);
-            targetTerritory->player = player;
+}
 
-            std::ostringstream stream;
-            stream << player->getName() << " is cheating and has conquered " << targetTerritory->name << " regardless of the game rules.";
-            saveEffect(stream.str());
+// Copy Constructor
+Advance::Advance(const Advance &other):
+    Order(other)
+{
 
-            // GameEngine will give this player a card and reset this flag to false
-            // before the start of the next turn
-            player->hasConqueredThisTurn = true;
-        }
+}
+
+// Parameterized Constructor
+Advance::Advance(int armies, Player& player, Territory& sourceTerritory, Territory& targetTerritory, bool cheat):
+    Order(OrderData::advance(armies, player, sourceTerritory, targetTerritory, cheat))
+{
 
-        return true;
-    }
-    else
-    {
-        return false;
-    }
 }
 
-//Validate : checks if an order is valid
-bool Advance::validate()
+// Destructor
+Advance::~Advance()
 {
-    if (player == nullptr || sourceTerritory == nullptr || targetTerritory == nullptr)
-    {
-        saveEffect("nullptr arguments passed", false);
-    }
-    else if (armies <= 0 || sourceTerritory->armies <= 0)
-    {
-        saveEffect("Not enough armies", false);
-    }
-    else if (std::find(player->getUnattackable().begin(), player->getUnattackable().end(), targetTerritory->player) != player->getUnattackable().end())
-    {
-        saveEffect("Can't attack diplomatic ally", false);
-    }
-    else if (!player->hasTerritory(sourceTerritory))
-    {
-        saveEffect("The source territory does not belong to the player that issued the order", false);
-    }
-    else if (!targetTerritory->isNeighbor(sourceTerritory) && this->cheat != true)
-    {
-        saveEffect("The target territory is not adjacent to the source territory", false);
-    }
-    else
-    {
-        return true;
-    }
 
-    return false;
 }
 
 // Assignment operator
 Advance& Advance::operator = (const Advance& other)
 {
     Order::operator = (other);
-    armies = other.armies;
-    player = other.player;
-    sourceTerritory = other.sourceTerritory;
-    targetTerritory = other.targetTerritory;
     return *this;
 }
 
@@ -596,25 +1211,9 @@ ostream& operator<<(ostream& out, const Advance& source)
     return source.print(out);
 }
 
-// Print method to display the description and effect of the order
-ostream& Advance::print(ostream& out) const
-{
-    std::string playerName = player == nullptr ? "nullptr" : player->getName();
-    out << "[" << getType() << " | " << playerName << "]";
-    if (executed)
-    {
-        out << " executed";
-    }
-    if (effect.size() > 0)
-    {
-        out << ": " << effect;
-    }
-    return out;
-}
-
 Territory* Advance::getSourceTerritory() const
 {
-    return this->sourceTerritory;
+    return data.sourceTerritory;
 }
 
 
@@ -623,33 +1222,23 @@ Territory* Advance::getSourceTerritory() const
 
 // Default Constructor
 Bomb::Bomb():
-    Order(),
-    player(nullptr),
-    territory(nullptr)
+    Order(Type::Bomb)
 {
-    this->setType(Type::Bomb);
+
 }
 
 // Copy Constructor
 Bomb::Bomb(const Bomb& other):
-    Order(other),
-    player(other.player),
-    territory(other.territory)
+    Order(other)
 {
-    this->setType(Type::Bomb);
+
 }
 
 // Parameterized Constructor
 Bomb::Bomb(Player& player, Territory& territory):
-    Order(),
-    player(&player),
-    territory(&territory)
+    Order(OrderData::bomb(player, territory))
 {
-    this->setType(Type::Bomb);
 
-    std::ostringstream stream;
-    stream << "Will bomb territory " << territory.name << ". It has " << territory.armies << " armies.";
-    effect = stream.str();
 }
 
 // Destructor
@@ -658,70 +1247,10 @@ Bomb::~Bomb()
 
 }
 
-// Execute : First validates the order, and if valid executes its action
-bool Bomb::execute()
-{
-    if (validate())
-    {
-        int initialArmies = territory->armies;
-        territory->armies /= 2;
-
-        std::ostringstream stream;
-        stream << "Bombed territory " << territory->name << ". It had " << initialArmies << " armies, now " << territory->armies << " are left.";
-        saveEffect(stream.str());
-
-        return true;
-    }
-    else
-    {
-        return false;
-    }
-}
-
-// Validate : checks if an order is valid
-bool Bomb::validate()
-{
-    if (player == nullptr || territory == nullptr)
-    {
-        saveEffect("nullptr arguments passed", false);
-    }
-    else if (player == territory->player)
-    {
-        saveEffect("Can't bomb own territory", false);
-    }
-    else if (std::find(player->getUnattackable().begin(), player->getUnattackable().end(), territory->player) != player->getUnattackable().end())
-    {
-        saveEffect("Can't bomb a diplomatic ally", false);
-    }
-    else
-    {
-        bool isAdjacent = false;
-        for (Territory* playerTerritory : player->getTerritories())
-        {
-            if (territory->isNeighbor(playerTerritory))
-            {
-                isAdjacent = true;
-                break;
-            }
-        }
-
-        if (!isAdjacent)
-        {
-            saveEffect("Can't bomb a territory that is not adjacent to an owned territory", false);
-        }
-
-        return isAdjacent;
-    }
-
-    return false;
-}
-
 // Assignment operator
 Bomb& Bomb::operator = (const Bomb& other)
 {
     Order::operator = (other);
-    player = other.player;
-    territory = other.territory;
     return *this;
 }
 
@@ -731,22 +1260,6 @@ ostream& operator << (ostream& out, const Bomb& source)
     return source.print(out);
 }
 
-// Print method to display the description and effect of the order
-ostream& Bomb::print(ostream& out) const
-{
-    std::string playerName = player == nullptr ? "nullptr" : player->getName();
-    out << "[" << getType() << " | " << playerName << "]";
-    if (executed)
-    {
-        out << " executed";
-    }
-    if (effect.size() > 0)
-    {
-        out << ": " << effect;
-    }
-    return out;
-}
-
 
 
 
@@ -754,36 +1267,23 @@ ostream& Bomb::print(ostream& out) const
 
 // Default Constructor
 Blockade::Blockade():
-    Order(),
-    player(nullptr),
-    neutralPlayer(nullptr),
-    territory(nullptr)
+    Order(Type::Blockade)
 {
-    this->setType(Type::Blockade);
+
 }
 
 // Copy Constructor
 Blockade::Blockade(const Blockade& other):
-    Order(other),
-    player(other.player),
-    neutralPlayer(other.neutralPlayer),
-    territory(other.territory)
+    Order(other)
 {
-    this->setType(Type::Blockade);
+
 }
 
 // Parameterized Constructor
 Blockade::Blockade(Player& player, Player& neutralPlayer, Territory& territory):
-    Order(),
-    player(&player),
-    neutralPlayer(&neutralPlayer),
-    territory(&territory)
+    Order(OrderData::blockade(player, neutralPlayer, territory))
 {
-    this->setType(Type::Blockade);
 
-    std::ostringstream stream;
-    stream << "Will blockade territory " << territory.name << ". It has " << territory.armies << " armies.";
-    effect = stream.str();
 }
 
 // Destructor
@@ -792,55 +1292,10 @@ Blockade::~Blockade()
 
 }
 
-// Execute : First validates the order, and if valid executes its action
-bool Blockade::execute()
-{
-    if (validate())
-    {
-        int initialArmies = territory->armies;
-        territory->armies *= 2;
-        territory->player->removeTerritory(territory);
-        neutralPlayer->addTerritory(territory);
-        territory->player = neutralPlayer;
-
-        std::ostringstream stream;
-        stream << "Blockaded territory " << territory->name << ". It had " << initialArmies << " armies, now it has " << territory->armies << ".";
-        saveEffect(stream.str());
-
-        return true;
-    }
-    else
-    {
-        return false;
-    }
-}
-
-// Validate : checks if an order is valid
-bool Blockade::validate()
-{
-    if (player == nullptr || neutralPlayer == nullptr || territory == nullptr)
-    {
-        saveEffect("nullptr arguments passed", false);
-    }
-    else if (player != territory->player)
-    {
-        saveEffect("Can't blockade another player's territory", false);
-    }
-    else
-    {
-        return true;
-    }
-
-    return false;
-}
-
 // Assignment operator
 Blockade& Blockade::operator = (const Blockade& other)
 {
     Order::operator = (other);
-    player = other.player;
-    neutralPlayer = other.neutralPlayer;
-    territory = other.territory;
     return *this;
 }
 
@@ -850,22 +1305,6 @@ ostream& operator << (ostream& out, const Blockade& source)
     return source.print(out);
 }
 
-// Print method to display the description and effect of the order
-ostream &Blockade::print(ostream& out) const
-{
-    std::string playerName = player == nullptr ? "nullptr" : player->getName();
-    out << "[" << getType() << " | " << playerName << "]";
-    if (executed)
-    {
-        out << " executed";
-    }
-    if (effect.size() > 0)
-    {
-        out << ": " << effect;
-    }
-    return out;
-}
-
 
 
 
@@ -873,39 +1312,23 @@ ostream &Blockade::print(ostream& out) const
 
 // Default Constructor
 Airlift::Airlift():
-    Order(),
-    armies(0),
-    player(nullptr),
-    sourceTerritory(nullptr),
-    targetTerritory(nullptr)
+    Order(Type::Airlift)
 {
-    this->setType(Type::Airlift);
+
 }
 
 // Copy Constructor
 Airlift::Airlift(const Airlift& other):
-    Order(other),
-    armies(other.armies),
-    player(other.player),
-    sourceTerritory(other.sourceTerritory),
-    targetTerritory(other.targetTerritory)
+    Order(other)
 {
-    this->setType(Type::Airlift);
+
 }
 
 //Parameterized Constructor
 Airlift::Airlift(int armies, Player& player, Territory& sourceTerritory, Territory& targetTerritory):
-    Order(),
-    armies(armies),
-    player(&player),
-    sourceTerritory(&sourceTerritory),
-    targetTerritory(&targetTerritory)
+    Order(OrderData::airlift(armies, player, sourceTerritory, targetTerritory))
 {
-    this->setType(Type::Airlift);
 
-    std::ostringstream stream;
-    stream << "Will airlift " << armies << " armies from territory " << sourceTerritory.name << " to " << targetTerritory.name;
-    effect = stream.str();
 }
 
 // Destructor
@@ -914,58 +1337,10 @@ Airlift::~Airlift()
 
 }
 
-// Execute : First validates the order, and if valid executes its action
-bool Airlift::execute()
-{
-    if (validate())
-    {
-        sourceTerritory->armies -= armies;
-        targetTerritory->armies += armies;
-
-        std::ostringstream stream;
-        stream << "Airlifted " << armies << " armies from territory " << sourceTerritory->name << " to " << targetTerritory->name;
-        saveEffect(stream.str());
-
-        return true;
-    }
-    return false;
-}
-
-// Validate : checks if an order is valid
-bool Airlift::validate()
-{
-    if (player == nullptr || sourceTerritory == nullptr || targetTerritory == nullptr)
-    {
-        saveEffect("nullptr arguments passed", false);
-    }
-    else if (armies < 0)
-    {
-        saveEffect("Not enough armies", false);
-    }
-    else if (player != sourceTerritory->player)
-    {
-        saveEffect("Source territory doesn't belong to player", false);
-    }
-    else if (player != targetTerritory->player)
-    {
-        saveEffect("Target territory doesn't belong to player", false);
-    }
-    else
-    {
-        return true;
-    }
-
-    return false;
-}
-
 // Assignment operator
 Airlift &Airlift::operator = (const Airlift& other)
 {
     Order::operator = (other);
-    armies = other.armies;
-    player = other.player;
-    sourceTerritory = other.sourceTerritory;
-    targetTerritory = other.targetTerritory;
     return *this;
 }
 
@@ -975,22 +1350,6 @@ ostream& operator << (ostream& out, const Airlift& source)
     return source.print(out);
 }
 
-// Print method to display the description and effect of the order
-ostream& Airlift::print(ostream& out) const
-{
-    std::string playerName = player == nullptr ? "nullptr" : player->getName();
-    out << "[" << getType() << " | " << playerName << "]";
-    if (executed)
-    {
-        out << " executed";
-    }
-    if (effect.size() > 0)
-    {
-        out << ": " << effect;
-    }
-    return out;
-}
-
 
 
 
@@ -998,33 +1357,23 @@ ostream& Airlift::print(ostream& out) const
 
 // Default Constructor
 Negotiate::Negotiate():
-    Order(),
-    player(nullptr),
-    targetPlayer(nullptr)
+    Order(Type::Negotiate)
 {
-    this->setType(Type::Negotiate);
+
 }
 
 // Copy Constructor
 Negotiate::Negotiate(const Negotiate& other):
-    Order(other),
-    player(other.player),
-    targetPlayer(other.targetPlayer)
+    Order(other)
 {
-    this->setType(Type::Negotiate);
+
 }
 
 // Parameterized Constructor
 Negotiate::Negotiate(Player& player, Player& targetPlayer):
-    Order(),
-    player(&player),
-    targetPlayer(&targetPlayer)
+    Order(OrderData::negotiate(player, targetPlayer))
 {
-    this->setType(Type::Negotiate);
 
-    std::ostringstream stream;
-    stream << targetPlayer.getName() << " will be a diplomatic ally for this turn.";
-    effect = stream.str();
 }
 
 // Destructor
@@ -1033,51 +1382,10 @@ Negotiate::~Negotiate()
 
 }
 
-// Execute : First validates the order, and if valid executes its action
-bool Negotiate::execute()
-{
-    if (validate())
-    {
-        player->setUnattackable(targetPlayer);
-        targetPlayer->setUnattackable(player);
-
-        std::ostringstream stream;
-        stream << targetPlayer->getName() << " is a diplomatic ally for this turn.";
-        saveEffect(stream.str());
-
-        return true;
-    }
-    else
-    {
-        return false;
-    }
-}
-
-// Validate : checks if an order is valid
-bool Negotiate::validate()
-{
-    if (player == nullptr || targetPlayer == nullptr)
-    {
-        saveEffect("nullptr arguments passed", false);
-    }
-    else if (player == targetPlayer)
-    {
-        saveEffect("Can't negotiate with oneself", false);
-    }
-    else
-    {
-        return true;
-    }
-
-    return false;
-}
-
 // Assignment operator
 Negotiate& Negotiate::operator = (const Negotiate& other)
 {
     Order::operator = (other);
-    player = other.player;
-    targetPlayer = other.targetPlayer;
     return *this;
 }
 
@@ -1086,19 +1394,3 @@ ostream& operator << (ostream& out, const Negotiate& source)
 {
     return source.print(out);
 }
-
-// Print method to display the description and effect of the order
-ostream& Negotiate::print(ostream& out) const
-{
-    std::string playerName = player == nullptr ? "nullptr" : player->getName();
-    out << "[" << getType() << " | " << playerName << "]";
-    if (executed)
-    {
-        out << " executed";
-    }
-    if (effect.size() > 0)
-    {
-        out << ": " << effect;
-    }
-    return out;
-}
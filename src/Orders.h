@@ -1,86 +1,242 @@
 #pragma once
-#include "LoggingObserver.h"
 #include "Cards.h"
+#include "EventBus.h"
+#include <cstddef>
 #include <iostream>
+#include <iterator>
 #include <string>
 #include <vector>
 
+class Continent;
+class GameContext;
 class Map;
 class Player;
 class Territory;
 
 using namespace std;
 
-// ==================== Order Class ====================
-class Order : public Subject, public ILoggable
+// Enum of order types
+enum class OrderType
 {
-public:
+    Order,
+    Deploy,
+    Advance,
+    Bomb,
+    Blockade,
+    Airlift,
+    Negotiate
+};
+
+// Stream output operator of OrderType
+std::ostream& operator << (std::ostream& out, const OrderType source);
 
-    // Enum of order types
-    enum class Type
+struct OrderData;
+
+// ==================== OrderEffect Struct ====================
+// Outcome of an order, recorded as numbers when the order is issued or executed.
+// It is only turned into text when printed, which only happens when an observer logs it.
+struct OrderEffect
+{
+    // Kinds of outcomes
+    enum class Kind
     {
-        Order,
-        Deploy,
-        Advance,
-        Bomb,
-        Blockade,
-        Airlift,
-        Negotiate
+        None,                                                           // Nothing recorded
+        Issued,                                                         // The order was issued, and will do what it describes once executed
+        Invalid,                                                        // The order didn't pass validation
+        Deployed,                                                       // Deploy
+        Moved,                                                          // Advance between two territories of the player
+        Attacked,                                                       // Advance that didn't conquer the target territory
+        Conquered,                                                      // Advance that conquered the target territory
+        Cheated,                                                        // Advance that conquered the target territory regardless of the game rules
+        Bombed,                                                         // Bomb
+        Blockaded,                                                      // Blockade
+        Airlifted,                                                      // Airlift
+        Negotiated                                                      // Negotiate
     };
 
-    // Stream output operator of Order_Type
-    friend std::ostream& operator << (std::ostream& out, const Type source);
+    Kind kind;                                                          // Kind of outcome
+    const char* reason;                                                 // Invalid: why the order was rejected
+    int armiesBefore;                                                   // Bombed, Blockaded, Issued: armies on the target territory before the order
+    int armiesAfter;                                                    // Bombed, Blockaded: armies on the target territory after the order
+    int attackersLeft;                                                  // Attacked, Conquered: attacking armies left
+    int defendersLeft;                                                  // Attacked: defending armies left
+    const Player* capturingPlayer;                                      // Player who gained the target territory's whole continent (nullptr if none)
+    const Continent* capturedContinent;                                 // Continent that the order completed for capturingPlayer
+
+    OrderEffect();                                                      // Default Constructor (nothing recorded)
+    static OrderEffect issued(const OrderData& order);                  // Outcome of an order that was just issued
+    static OrderEffect invalid(const char* reason);                     // Outcome of an order that didn't pass validation
+    bool empty() const;                                                 // Checks if nothing was recorded
+    ostream& print(ostream& out, const OrderData& order) const;         // Prints the outcome of an order as text
+};
+
+// ==================== OrderData Struct ====================
+// Compact value-type encoding of an order: its type and arguments, without any state of its own.
+// OrdersList stores orders in this form, one after the other, and the Order classes wrap one.
+// An OrderData of type Order is empty, it's what strategies issue when they have no more orders.
+struct OrderData
+{
+    OrderType type;                                                     // Type of the order
+    bool cheat;                                                         // Advance: conquer regardless of the game rules
+    int armies;                                                         // Deploy, Advance, Airlift: number of armies
+    Player* player;                                                     // Player who issued the order
+    Player* targetPlayer;                                               // Blockade: neutral player, Negotiate: player to negotiate with
+    Territory* sourceTerritory;                                         // Advance, Airlift: territory the armies leave
+    Territory* targetTerritory;                                         // Territory the order applies to (destination of Advance and Airlift)
+
+    OrderData();                                                        // Default Constructor (empty order)
+
+    // Factories for each type of order, with the same arguments as the matching Order classes.
+    // Like the Deploy constructor, deploy moves the armies out of the player's reinforcement pool right away.
+    static OrderData deploy(int armies, Player& player, Territory& territory);
+    static OrderData advance(int armies, Player& player, Territory& sourceTerritory, Territory& targetTerritory, bool cheat = false);
+    static OrderData bomb(Player& player, Territory& territory);
+    static OrderData blockade(Player& player, Player& neutralPlayer, Territory& territory);
+    static OrderData airlift(int armies, Player& player, Territory& sourceTerritory, Territory& targetTerritory);
+    static OrderData negotiate(Player& player, Player& targetPlayer);
+
+    bool empty() const;                                                 // Checks if this is an empty order
+    bool validate(OrderEffect& effect) const;                           // Checks if the order is valid, effect receives why it isn't
+    bool execute(GameContext& context, OrderEffect& effect);            // First validates the order, and if valid executes its action. effect receives the outcome.
+    ostream& print(ostream& out, bool executed, const OrderEffect& effect) const; // Prints the order with an outcome, like Order::print
+};
+
+// ==================== OrderEvent Struct ====================
+// Event published when an order is added to an OrdersList, or executed
+struct OrderEvent
+{
+    const OrderData& order;                                             // The order
+    bool added;                                                         // Whether it was added rather than executed
+    bool executed;                                                      // Whether it was executed (false when it was added or invalid)
+    const OrderEffect& effect;                                          // Outcome of the execution, or the description of the added order
+
+    ostream& print(ostream& out) const;                                 // Prints the event as it is logged
+};
+
+// ==================== Order Class ====================
+// Object wrapper around an OrderData, for code that prefers handling orders one object at a time (ex: human input)
+class Order
+{
+public:
+
+    // Order types
+    typedef OrderType Type;
 
     Order();                                                            // Default Constructor
     Order(const Order& other);                                          // Copy Constructor
     virtual ~Order();                                                           // Destructor
     explicit Order(const Type orderType);                               // Parameterized Constructor to define the type of Order
+    explicit Order(const OrderData& data);                              // Parameterized Constructor wrapping an encoded order
     Type getType() const;                                               // Getter for the order type
+    const OrderData& getData() const;                                   // Getter for the encoded order
     Order& operator = (const Order& other);                             // Assignment operator overloading
     friend ostream& operator << (ostream& out, const Order& source);    // Input stream operator
-    virtual bool execute() = 0;                                         // Pure virtual method execute();
+    virtual bool execute(GameContext& context);                         // Executes the order, given the state of the game being played
     virtual bool validate();                                            // Checks if the order is valid
     virtual ostream& print(ostream& out) const;                         // Prints to an output stream
     bool getExecuted() const;                                           // Getter for executed boolean
-    // Implementation of stringToLog function inherited from ILoggable
-    string stringToLog();
 
 protected:
 
     void setType(Type orderType);                                       // Setter for the order type
-    void saveEffect(const std::string& effect, bool executed = true);   // Sets execution effect
+    void saveEffect(const OrderEffect& effect, bool executed = true);   // Sets execution effect (publishing it is up to the caller)
 
+    OrderData data;                                                     // The encoded order
     bool executed;                                                      // Boolean to check if order has been executed or not
-    string effect;                                                      // Holds the execution effect
-
-private:
-
-    Type orderType;
+    OrderEffect effect;                                                 // Holds the execution effect
 };
 
 // ==================== OrderList Class ====================
-class OrdersList : public Subject, public ILoggable
+// Queue of orders, stored by value in a ring buffer so that orders are taken from the front in constant time.
+// The buffer is kept from one turn to the next, so a turn's orders normally don't allocate anything.
+class OrdersList
 {
 public:
 
+    // Read-only iterator over the orders, from front to back
+    class Iterator
+    {
+    public:
+
+        // Iterator traits, for standard algorithms
+        typedef std::forward_iterator_tag iterator_category;
+        typedef OrderData value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const OrderData* pointer;
+        typedef const OrderData& reference;
+
+        Iterator(const OrdersList& ordersList, size_t position);         // Parameterized Constructor
+        const OrderData& operator * () const;                           // Returns the current order
+        Iterator& operator ++ ();                                       // Moves to the next order
+        bool operator == (const Iterator& other) const;                 // Equality operator
+        bool operator != (const Iterator& other) const;                 // Inequality operator
+
+    private:
+
+        const OrdersList* ordersList;
+        size_t position;
+    };
+
     OrdersList();                                                           // Default Constructor
     OrdersList(const OrdersList& other);                                    // Copy Constructor
     explicit OrdersList(const vector<Order*>& other);
     ~OrdersList();                                                          // Destructor
     void remove(int index);                                                 // Removes the order from the list at specified index
+    void removeFront();                                                     // Removes the first order of the list, in constant time
+    bool executeFront(GameContext& context);                                // Executes the first order of the list, then removes it. Returns if it was valid.
     void move(int from, int to);                                            // Moves an order from position x (from) to position y (to)
-    void addOrder(Order* order);                                            // Adds an order to the list
+    void addOrder(const OrderData& order);                                  // Adds an order to the list
+    void addOrder(const OrderData& order, const OrderEffect& issued);       // Adds an order to the list, described as it was when issued
+    void addOrder(Order* order);                                            // Adds an order object to the list, and deletes it
+    void reserve(size_t capacity);                                          // Makes room for a number of orders, so that adding them doesn't reallocate
     OrdersList& operator = (const OrdersList& other);                       // Assignment operator overloading
     friend ostream& operator<<(ostream& out, const OrdersList& source);     // Stream insertion operator
-    vector<Order*>& getOrdersList();                                        // Getter for orders list
-    const vector<Order*>& getOrdersList() const;                            // Const getter for orders list
-    // Implementation of stringToLog function inherited from ILoggable
-    string stringToLog();
+    size_t size() const;                                                    // Number of orders in the list
+    bool empty() const;                                                     // Checks if the list has no orders
+    const OrderData& at(size_t index) const;                                // Returns the order at specified index
+    const OrderData& front() const;                                         // Returns the first order (the list must not be empty)
+    const OrderData& back() const;                                          // Returns the last order (the list must not be empty)
+    Iterator begin() const;                                                 // Iterators, for range-based for loops
+    Iterator end() const;
+
+private:
+
+    vector<OrderData> slots;                                                // Ring buffer of orders, its size is 0 or a power of 2
+    size_t head;                                                            // Slot of the first order
+    size_t count;                                                           // Number of orders in the list
+    OrderData& slot(size_t index);                                          // Returns the slot of the order at specified index
+    const OrderData& slot(size_t index) const;
+    void grow(size_t capacity);                                             // Moves the orders to a larger ring buffer, starting at slot 0
+};
+
+// ==================== OrderSink Class ====================
+// Receives the orders a player issues for a whole turn at once (see PlayerStrategy::issueOrders), in the order they
+// were issued. The game engine then queues them in the players' orders lists, one order per player at a time.
+// Each order keeps its description from when it was issued, before the player's next deploys changed any armies.
+// A player who passes a round (see PlayerStrategy::isDoneIssuing) ends its batch there: if the issue orders phase goes
+// on, the game engine asks it for the rest of its orders one by one, as their turn comes.
+class OrderSink
+{
+public:
+
+    OrderSink();                                                            // Default Constructor
+    OrderSink(const OrderSink& other);                                      // Copy Constructor
+    ~OrderSink();                                                           // Destructor
+    OrderSink& operator = (const OrderSink& other);                         // Assignment operator overloading
+    friend ostream& operator<<(ostream& out, const OrderSink& source);      // Stream insertion operator
+    void add(const OrderData& order);                                       // Adds an order after the ones already issued
+    void pass();                                                            // Ends the batch with a round without an order
+    bool hasPassed() const;                                                 // Checks if the batch ends with a round without an order
+    void clear();                                                           // Forgets the orders, keeping the memory for the next turn
+    size_t size() const;                                                    // Number of orders issued
+    const OrderData& at(size_t index) const;                                // Returns the order issued at specified index
+    const OrderEffect& effectAt(size_t index) const;                        // Returns the description of the order issued at specified index
 
 private:
 
-    vector<Order*> orderList;                                               // List (vector) of orders
-    void deepCopy(const vector<Order*>& orderList);                         // Deep copy a list of orders
+    vector<OrderData> orders;                                               // Orders in the order they were issued
+    vector<OrderEffect> effects;                                            // Descriptions of the orders, when they were issued
+    bool passed;                                                            // The player passed the round after its last order
 };
 
 
@@ -95,17 +251,8 @@ public:
     Deploy(const Deploy& other);                                                                        // Copy Constructor
     Deploy(int armies, Player& player, Territory& territory);                                           // Parameterized Constructor
     ~Deploy();                                                                                          // Destructor
-    bool execute() override;                                                                            // First validates the order, and if valid executes its action
-    bool validate() override;                                                                           // Checks if the order is valid
     Deploy& operator = (const Deploy& other);                                                           // Assignment operator overloading
     friend ostream& operator << (ostream& out, const Deploy& source);                                   // Stream Insertion Operator
-    ostream& print(ostream& out) const override;                                                        // Prints to an output stream
-
-private:
-
-    int armies;
-    Player* player;
-    Territory* territory;
 };
 
 // ==================== Advance Class ====================
@@ -117,20 +264,9 @@ public:
     Advance(const Advance& other);                                      // Copy Constructor
     Advance(int armies, Player& player, Territory& sourceTerritory, Territory& targetTerritory, bool cheat=false);    // Parameterized Constructor
     ~Advance();                                                         // Destructor
-    bool execute() override;                                            // First validates the order, and if valid executes its action
-    bool validate() override;                                           // Checks if the order is valid
     Advance& operator = (const Advance& advance);                       // Assignment operator overloading
     friend ostream& operator << (ostream& out, const Advance& source);  // Stream Insertion Operator
-    ostream& print(ostream& out) const override;                        // Prints to an output stream
     Territory* getSourceTerritory() const;                              // Returns the source territory
-
-private:
-
-    int armies;
-    Player* player;
-    Territory* sourceTerritory;
-    Territory* targetTerritory;
-    bool cheat;
 };
 
 // ==================== Bomb Class ====================
@@ -142,16 +278,8 @@ public:
     Bomb(const Bomb& other);                                            // Copy Constructor
     Bomb(Player& player, Territory& territory);                         // Parameterized Constructor
     ~Bomb();                                                            // Destructor
-    bool execute() override;                                            // First validates the order, and if valid executes its action
-    bool validate() override;                                           // Checks if the order is valid
     Bomb& operator = (const Bomb& other);                               // Assignment operator overloading
     friend ostream& operator << (ostream& out, const Bomb& source);     // Stream Insertion Operator
-    ostream& print(ostream& out) const override;      
-
-private:
-
-    Player* player;
-    Territory* territory;
 };
 
 // ==================== Blockade Class ====================
@@ -163,17 +291,8 @@ public:
     Blockade(const Blockade& other);                                        // Copy Constructor
     Blockade(Player& player, Player& neutralPlayer, Territory& territory);  // Parameterized Constructor
     ~Blockade();                                                            // Destructor
-    bool execute() override;                                                // First validates the order, and if valid executes its action
-    bool validate() override;                                               // Checks if the order is valid
     Blockade& operator = (const Blockade& other);                           // Assignment operator overloading
     friend ostream& operator << (ostream& out, const Blockade& source);     // Stream Insertion Operator
-    ostream& print(ostream& out) const override;                            // Prints to an output stream
-
-private:
-
-    Player* player;
-    Player* neutralPlayer;
-    Territory* territory;
 };
 
 // ==================== Airlift Class ====================
@@ -185,18 +304,8 @@ public:
     Airlift(const Airlift& other);                                          // Copy Constructor
     Airlift(int armies, Player& player, Territory& sourceTerritory, Territory& targetTerritory);  // Parameterized Constructor
     ~Airlift();                                                             // Destructor
-    bool execute() override;                                                // First validates the order, and if valid executes its action
-    bool validate() override;                                               // Checks if the order is valid
     Airlift& operator = (const Airlift& other);                             // Assignment operator overloading
     friend ostream& operator << (ostream& out, const Airlift& source);      // Stream Insertion Operator
-    ostream& print(ostream& out) const override;                            // Prints to an output stream
-
-private:
-
-    int armies;
-    Player* player;
-    Territory* targetTerritory;
-    Territory* sourceTerritory;
 };
 
 // ==================== Negotiate Class ====================
@@ -208,14 +317,6 @@ public:
     Negotiate(const Negotiate& other);                                          // Copy Constructor
     Negotiate(Player& player, Player& targetPlayer);                            // Parameterized Constructor
     ~Negotiate();                                                               // Destructor
-    bool execute() override;                                                    // First validates the order, and if valid executes its action
-    bool validate() override;                                                   // Checks if the order is valid
     Negotiate& operator = (const Negotiate& other);                             // Assignment operator overloading
     friend ostream& operator << (ostream& out, const Negotiate& source);        // Stream Insertion Operator
-    ostream& print(ostream& out) const override;                                // Prints to an output stream
-
-private:
-
-    Player* player;
-    Player* targetPlayer;
 };
@@ -2,6 +2,27 @@
 #include "PlayerStrategies.h"
 #include "GameEngine.h"
 
+// Marks a territory that isn't in a frontier list
+static const size_t noSlot = static_cast<size_t>(-1);
+
+// Appends a territory to a frontier list, recording its position
+static void insertFrontier(vector<Territory*>& list, vector<size_t>& slots, Territory* territory)
+{
+    slots[territory->ID - 1] = list.size();
+    list.push_back(territory);
+}
+
+// Removes a territory from a frontier list in constant time, by moving the last territory into its slot
+static void eraseFrontier(vector<Territory*>& list, vector<size_t>& slots, Territory* territory)
+{
+    const size_t slot = slots[territory->ID - 1];
+    Territory* lastTerritory = list.back();
+    slots[lastTerritory->ID - 1] = slot;
+    list[slot] = lastTerritory;
+    list.pop_back();
+    slots[territory->ID - 1] = noSlot;
+}
+
 // Constructors
 // Default constructor
 Player::Player():
@@ -10,7 +31,14 @@ Player::Player():
     orders(new OrdersList()),
     armies(0),
     hasConqueredThisTurn(false),
-    strategy(nullptr)
+    strategy(nullptr),
+    attackableTerritories(),
+    borderTerritories(),
+    ownedBorderCounts(),
+    enemyBorderCounts(),
+    attackableSlots(),
+    borderSlots(),
+    continentTerritoryCounts()
 {
 
 }
@@ -20,7 +48,14 @@ Player::Player(const Player& other):
     territories(other.territories),
     armies(other.armies),
     hasConqueredThisTurn(other.hasConqueredThisTurn),
-    strategy(other.strategy)
+    strategy(other.strategy),
+    attackableTerritories(other.attackableTerritories),
+    borderTerritories(other.borderTerritories),
+    ownedBorderCounts(other.ownedBorderCounts),
+    enemyBorderCounts(other.enemyBorderCounts),
+    attackableSlots(other.attackableSlots),
+    borderSlots(other.borderSlots),
+    continentTerritoryCounts(other.continentTerritoryCounts)
 {
     delete this->cards;
     delete this->orders;
@@ -37,11 +72,37 @@ Player::~Player()
 }
 
 // Accessors
-vector<Territory*>& Player::getTerritories()
+const vector<Territory*>& Player::getTerritories() const
 {
     return territories;
 }
 
+const vector<Territory*>& Player::getAttackableTerritories() const
+{
+    return attackableTerritories;
+}
+
+const vector<Territory*>& Player::getBorderTerritories() const
+{
+    return borderTerritories;
+}
+
+size_t Player::getContinentTerritoryCount(const Continent& continent) const
+{
+    const size_t index = continent.ID - 1;
+    return index < continentTerritoryCounts.size() ? continentTerritoryCounts[index] : 0;
+}
+
+size_t Player::getMissingTerritoryCount(const Continent& continent) const
+{
+    return continent.territories.size() - getContinentTerritoryCount(continent);
+}
+
+bool Player::controlsContinent(const Continent& continent) const
+{
+    return getMissingTerritoryCount(continent) == 0;
+}
+
 Hand* Player::getCards()
 {
     return cards;
@@ -73,7 +134,22 @@ vector<Player*>& Player::getUnattackable()
 // Mutators
 void Player::setTerritories(vector<Territory*>& territories)
 {
-    this->territories = territories;
+    for (Territory* territory : this->territories)
+    {
+        if (territory->player == this)
+        {
+            territory->player = nullptr;
+        }
+    }
+
+    this->territories.clear();
+    continentTerritoryCounts.clear();
+    clearFrontier();
+
+    for (Territory* territory : territories)
+    {
+        addTerritory(territory);
+    }
 }
 
 void Player::setCards(Hand* cards)
@@ -96,24 +172,144 @@ void Player::setName(const std::string& name)
     this->name = name;
 }
 
-// Adds a new owned territory to player
+// Adds a new owned territory to player, and updates the frontier around it
 void Player::addTerritory(Territory* territory)
 {
+    territory->player = this;
+    territory->playerSlot = territories.size();
     territories.push_back(territory);
+
+    const size_t continentIndex = territory->continentID - 1;
+    if (continentIndex >= continentTerritoryCounts.size())
+    {
+        continentTerritoryCounts.resize(continentIndex + 1, 0);
+    }
+    continentTerritoryCounts[continentIndex]++;
+
+    const size_t index = trackTerritory(territory);
+
+    // The territory's neighbors can now be attacked from it, unless they are owned
+    unsigned int enemyBorders = 0;
+    for (Territory* neighbor : territory->neighbors)
+    {
+        const size_t neighborIndex = trackTerritory(neighbor);
+        if (neighbor->player != this)
+        {
+            enemyBorders++;
+            if (++ownedBorderCounts[neighborIndex] == 1)
+            {
+                insertFrontier(attackableTerritories, attackableSlots, neighbor);
+            }
+        }
+        else
+        {
+            ownedBorderCounts[neighborIndex]++;
+        }
+    }
+
+    enemyBorderCounts[index] = enemyBorders;
+    if (enemyBorders > 0)
+    {
+        insertFrontier(borderTerritories, borderSlots, territory);
+    }
+
+    if (attackableSlots[index] != noSlot)
+    {
+        eraseFrontier(attackableTerritories, attackableSlots, territory);
+    }
+
+    // Owned territories bordering it have one less enemy neighbor
+    for (Territory* incomingNeighbor : territory->incomingNeighbors)
+    {
+        if (incomingNeighbor->player == this && incomingNeighbor != territory)
+        {
+            const size_t incomingIndex = trackTerritory(incomingNeighbor);
+            if (--enemyBorderCounts[incomingIndex] == 0)
+            {
+                eraseFrontier(borderTerritories, borderSlots, incomingNeighbor);
+            }
+        }
+    }
 }
 
+// Removes an owned territory in constant time, by moving the last territory into its slot,
+// and updates the frontier around it
 bool Player::removeTerritory(Territory* territory)
 {
-    std::vector<Territory*>::iterator it = std::find(territories.begin(), territories.end(), territory);
-    if (it == territories.end())
+    if (!hasTerritory(territory))
     {
         return false;
     }
-    else
+
+    Territory* lastTerritory = territories.back();
+    lastTerritory->playerSlot = territory->playerSlot;
+    territories[territory->playerSlot] = lastTerritory;
+    territories.pop_back();
+
+    territory->player = nullptr;
+
+    continentTerritoryCounts[territory->continentID - 1]--;
+
+    const size_t index = trackTerritory(territory);
+
+    // The territory's neighbors can't be attacked from it anymore
+    for (Territory* neighbor : territory->neighbors)
     {
-        territories.erase(it);
-        return true;
+        const size_t neighborIndex = trackTerritory(neighbor);
+        if (--ownedBorderCounts[neighborIndex] == 0 && attackableSlots[neighborIndex] != noSlot)
+        {
+            eraseFrontier(attackableTerritories, attackableSlots, neighbor);
+        }
     }
+
+    enemyBorderCounts[index] = 0;
+    if (borderSlots[index] != noSlot)
+    {
+        eraseFrontier(borderTerritories, borderSlots, territory);
+    }
+
+    if (ownedBorderCounts[index] > 0)
+    {
+        insertFrontier(attackableTerritories, attackableSlots, territory);
+    }
+
+    // Owned territories bordering it have one more enemy neighbor
+    for (Territory* incomingNeighbor : territory->incomingNeighbors)
+    {
+        if (incomingNeighbor->player == this)
+        {
+            const size_t incomingIndex = trackTerritory(incomingNeighbor);
+            if (enemyBorderCounts[incomingIndex]++ == 0)
+            {
+                insertFrontier(borderTerritories, borderSlots, incomingNeighbor);
+            }
+        }
+    }
+
+    return true;
+}
+
+size_t Player::trackTerritory(const Territory* territory)
+{
+    const size_t index = territory->ID - 1;
+    if (index >= ownedBorderCounts.size())
+    {
+        ownedBorderCounts.resize(index + 1, 0);
+        enemyBorderCounts.resize(index + 1, 0);
+        attackableSlots.resize(index + 1, noSlot);
+        borderSlots.resize(index + 1, noSlot);
+    }
+    return index;
+}
+
+void Player::clearFrontier()
+{
+    attackableTerritories.clear();
+    borderTerritories.clear();
+    ownedBorderCounts.clear();
+    enemyBorderCounts.clear();
+    attackableSlots.clear();
+    borderSlots.clear();
 }
 
 //Sets a player in the list of players that this player cannot attack
@@ -129,9 +325,9 @@ void Player::clearUnattackable()
 }
 
 //Checks if a player has a target territory
-bool Player::hasTerritory(Territory* target)
+bool Player::hasTerritory(Territory* target) const
 {
-    return std::find(territories.begin(), territories.end(), target) != territories.end();
+    return target != nullptr && target->player == this && target->playerSlot < territories.size() && territories[target->playerSlot] == target;
 }
 
 // Sets the issue order strategy
@@ -154,6 +350,13 @@ void Player::operator = (const Player& other)
     delete orders;
 
     territories = other.territories;
+    attackableTerritories = other.attackableTerritories;
+    borderTerritories = other.borderTerritories;
+    ownedBorderCounts = other.ownedBorderCounts;
+    enemyBorderCounts = other.enemyBorderCounts;
+    attackableSlots = other.attackableSlots;
+    borderSlots = other.borderSlots;
+    continentTerritoryCounts = other.continentTerritoryCounts;
     cards = new Hand(*(other.cards));
     orders = new OrdersList(*(other.orders));
     armies = other.armies;
@@ -184,7 +387,7 @@ ostream& operator << (ostream& out, const Player& source)
     if (source.cards != nullptr)
     {
         out << "\nPlayer's Hand:\n";
-        for (Card* c : source.cards->getCards())
+        for (Card* c : *source.cards)
         {
             out << *c << endl;
         }
@@ -197,9 +400,9 @@ ostream& operator << (ostream& out, const Player& source)
     if (source.orders != nullptr)
     {
         out << "\nPlayer's Orders:\n";
-        for (Order* o : source.orders->getOrdersList())
+        for (const OrderData& order : *source.orders)
         {
-            out << *o;
+            out << Order(order);
         }
     }
     else
@@ -211,7 +414,7 @@ ostream& operator << (ostream& out, const Player& source)
 }
 
 // Provides an order based on the current strategy
-Order* Player::issueOrder(GameEngine& gameEngine)
+OrderData Player::issueOrder(GameEngine& gameEngine)
 {
     if (strategy != nullptr)
     {
@@ -219,7 +422,37 @@ Order* Player::issueOrder(GameEngine& gameEngine)
     }
     else
     {
-        return nullptr;
+        return OrderData();
+    }
+}
+
+// Lets the current strategy plan the turn
+void Player::planTurn(GameEngine& gameEngine)
+{
+    if (strategy != nullptr)
+    {
+        strategy->planTurn(gameEngine);
+    }
+}
+
+// Checks if the player is done issuing orders this turn, based on the current strategy
+bool Player::isDoneIssuing() const
+{
+    return strategy == nullptr || strategy->isDoneIssuing();
+}
+
+// Checks if the orders of the turn can be provided at once, based on the current strategy
+bool Player::canIssueOrdersAtOnce() const
+{
+    return strategy == nullptr || strategy->canIssueOrdersAtOnce();
+}
+
+// Provides all the orders of the turn at once, based on the current strategy
+void Player::issueOrders(GameEngine& gameEngine, OrderSink& sink)
+{
+    if (strategy != nullptr)
+    {
+        strategy->issueOrders(gameEngine, sink);
     }
 }
 
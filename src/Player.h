@@ -26,8 +26,18 @@ public:
     ~Player();
 
     // Accessors
-    // Returns the collection of territories of the player
-    vector<Territory*>& getTerritories();
+    // Returns the collection of territories of the player, in no particular order
+    const vector<Territory*>& getTerritories() const;
+    // Returns the territories of other players that the player's territories border, in no particular order
+    const vector<Territory*>& getAttackableTerritories() const;
+    // Returns the territories of the player that border at least one territory of another player, in no particular order
+    const vector<Territory*>& getBorderTerritories() const;
+    // Returns the number of territories of a continent that the player owns
+    size_t getContinentTerritoryCount(const Continent& continent) const;
+    // Returns the number of territories of a continent that the player still has to conquer to control it
+    size_t getMissingTerritoryCount(const Continent& continent) const;
+    // Checks if the player owns every territory of a continent
+    bool controlsContinent(const Continent& continent) const;
     // Returns the cards owned by the player
     Hand* getCards();
     // Returns the orders queued by the player
@@ -41,11 +51,12 @@ public:
     // Returns the player's name
     const std::string& getName() const;
     // Checks if player owns a specific territory
-    bool hasTerritory(Territory* target);
+    bool hasTerritory(Territory* target) const;
     // Returns a list of players that the player can't attack
     vector<Player*>& getUnattackable();
 
     // Mutators
+    // Territory ownership changes go through these, which also update Territory::player
     void setTerritories(vector<Territory*>& territories);
     void addTerritory(Territory* territory);
     bool removeTerritory(Territory* territory);
@@ -62,8 +73,16 @@ public:
     // Stream insertion operator overloading
     friend ostream& operator << (ostream& out, const Player& source);
 
-    // Provides an order based on the current strategy
-    Order* issueOrder(GameEngine& gameEngine);
+    // Provides an order based on the current strategy (an empty order when there are no more orders to issue)
+    OrderData issueOrder(GameEngine& gameEngine);
+    // Lets the current strategy plan the turn, before the player issues its first order of the turn
+    void planTurn(GameEngine& gameEngine);
+    // After issueOrder provided an empty order: checks if the player has no more orders this turn, or only passed this round
+    bool isDoneIssuing() const;
+    // Checks if the current strategy can provide all the orders of the turn at once, without seeing the other players' orders
+    bool canIssueOrdersAtOnce() const;
+    // Provides all the orders of the turn at once, based on the current strategy
+    void issueOrders(GameEngine& gameEngine, OrderSink& sink);
 
     // Flag that grants a card on the next turn
     bool hasConqueredThisTurn;
@@ -77,6 +96,7 @@ private:
 
     // Required attributes
     // Represents the collection of territories of the player
+    // Each territory knows its position in it (Territory::playerSlot), so removals are O(1)
     vector<Territory*> territories;
     // Represents the collection of cards of the player
     Hand* cards;
@@ -93,4 +113,26 @@ private:
 
     // Strategy for issuing orders
     PlayerStrategy* strategy;
+
+    // Frontier of the player, updated territory by territory as ownership changes
+    // Territories of other players that the player's territories border
+    vector<Territory*> attackableTerritories;
+    // Territories of the player that border at least one territory of another player
+    vector<Territory*> borderTerritories;
+    // Per territory (index = ID - 1): number of borders leading to it from the player's territories
+    vector<unsigned int> ownedBorderCounts;
+    // Per territory (index = ID - 1): number of borders leading from it to other players' territories
+    vector<unsigned int> enemyBorderCounts;
+    // Per territory (index = ID - 1): position in attackableTerritories, if it's in it
+    vector<size_t> attackableSlots;
+    // Per territory (index = ID - 1): position in borderTerritories, if it's in it
+    vector<size_t> borderSlots;
+
+    // Per continent (index = ID - 1): number of territories of the continent owned by the player
+    vector<size_t> continentTerritoryCounts;
+
+    // Grows the per territory frontier vectors to cover a territory, and returns its index in them
+    size_t trackTerritory(const Territory* territory);
+    // Clears the frontier
+    void clearFrontier();
 };
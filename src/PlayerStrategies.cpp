@@ -8,64 +8,253 @@
 
 // Utils
 
-// Returns a list of territories that the player can attack
-vector<Territory*> canAttack(Player& player)
+// If one of the last three orders was a Deploy order, you can keep deploying
+bool canDeploy(Player& player)
+{
+    const OrdersList& orders = *player.getOrders();
+    if(orders.size() < 3) return true;
+    for(size_t i = orders.size() - 3; i < orders.size(); ++i)
+    {
+        if(orders.at(i).type == Order::Type::Deploy)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// TurnPlan
+
+TurnPlan::TurnPlan():
+    defenseCursor(0),
+    player(nullptr),
+    strongest(nullptr),
+    weakest(nullptr),
+    weakestEnemy(nullptr),
+    weakestArmies(0),
+    weakestEnemyArmies(0),
+    defenseOrder(),
+    advancedSources(),
+    issuedCount(0),
+    lastDeploy(0)
+{
+
+}
+
+TurnPlan::TurnPlan(const TurnPlan& other):
+    defenseCursor(other.defenseCursor),
+    player(other.player),
+    strongest(other.strongest),
+    weakest(other.weakest),
+    weakestEnemy(other.weakestEnemy),
+    weakestArmies(other.weakestArmies),
+    weakestEnemyArmies(other.weakestEnemyArmies),
+    defenseOrder(other.defenseOrder),
+    advancedSources(other.advancedSources),
+    issuedCount(other.issuedCount),
+    lastDeploy(other.lastDeploy)
+{
+
+}
+
+TurnPlan::~TurnPlan()
+{
+
+}
+
+TurnPlan& TurnPlan::operator = (const TurnPlan& other)
+{
+    defenseCursor = other.defenseCursor;
+    player = other.player;
+    strongest = other.strongest;
+    weakest = other.weakest;
+    weakestEnemy = other.weakestEnemy;
+    weakestArmies = other.weakestArmies;
+    weakestEnemyArmies = other.weakestEnemyArmies;
+    defenseOrder = other.defenseOrder;
+    advancedSources = other.advancedSources;
+    issuedCount = other.issuedCount;
+    lastDeploy = other.lastDeploy;
+    return *this;
+}
+
+std::ostream& operator << (std::ostream& out, const TurnPlan& source)
+{
+    out << "TurnPlan";
+    if (source.strongest != nullptr)
+    {
+        out << " (strongest: " << source.strongest->name << ", " << source.strongest->armies << " armies)";
+    }
+    return out;
+}
+
+// Computes the plan of a player for the turn that starts
+void TurnPlan::prepare(Player& player, const Map& map)
+{
+    this->player = &player;
+    const vector<Territory*>& territories = player.getTerritories();
+
+    // First territory with the most armies
+    strongest = nullptr;
+    for (Territory* territory : territories)
+    {
+        if (strongest == nullptr || territory->armies > strongest->armies)
+        {
+            strongest = territory;
+        }
+    }
+
+    weakest = findWeakest(territories);
+    weakestArmies = weakest != nullptr ? weakest->armies : 0;
+    weakestEnemy = findWeakest(player.getAttackableTerritories());
+    weakestEnemyArmies = weakestEnemy != nullptr ? weakestEnemy->armies : 0;
+
+    defenseOrder.clear();
+    defenseCursor = 0;
+    advancedSources.assign(map.territories.size(), false);
+    issuedCount = 0;
+    lastDeploy = 0;
+}
+
+// Orders the player's territories from the weakest to the strongest, keeping their order on ties
+void TurnPlan::prepareDefense()
 {
-    vector<Territory*> canAttack = vector<Territory*>();
+    defenseOrder = player->getTerritories();
+    stable_sort(defenseOrder.begin(), defenseOrder.end(), [](const Territory* a, const Territory* b)
+    {
+        return a->armies < b->armies;
+    });
+}
 
-    for (Territory* ownedTerritory : player.getTerritories())
+// Updates the plan with an order the player issues
+OrderData TurnPlan::issued(const OrderData& order)
+{
+    issuedCount++;
+
+    if (order.type == Order::Type::Deploy)
     {
-        for (Territory* neighbor : ownedTerritory->neighbors)
+        lastDeploy = issuedCount;
+    }
+
+    if (order.type == Order::Type::Deploy && order.targetTerritory->player == player)
+    {
+        // The deployed armies are already on the territory, which can only have become stronger
+        Territory* territory = order.targetTerritory;
+        if (strongest != territory && (territory->armies > strongest->armies || (territory->armies == strongest->armies && territory->playerSlot < strongest->playerSlot)))
         {
-            bool found = false;
+            strongest = territory;
+        }
 
-            // Only add to list if not owned by self
-            if (neighbor->player != &player)
+        // Move it forward in the defense order, to where sorting would have put it
+        if (!defenseOrder.empty())
+        {
+            size_t position = find(defenseOrder.begin(), defenseOrder.end(), territory) - defenseOrder.begin();
+            while (position + 1 < defenseOrder.size())
             {
-                // Make sure the current neighbor is not already in the list
-                bool found = find(canAttack.begin(), canAttack.end(), neighbor) != canAttack.end();
-                if (!found)
+                const Territory* next = defenseOrder[position + 1];
+                if (next->armies > territory->armies || (next->armies == territory->armies && next->playerSlot > territory->playerSlot))
                 {
-                    canAttack.push_back(neighbor);
+                    break;
                 }
+                defenseOrder[position] = defenseOrder[position + 1];
+                defenseOrder[++position] = territory;
             }
+            defenseCursor = 0;
         }
     }
+    else if (order.type == Order::Type::Advance)
+    {
+        advancedSources[order.sourceTerritory->ID - 1] = true;
+    }
 
-    return canAttack;
+    return order;
 }
 
-// If one of the last three orders was a Deploy order, you can keep deploying
-bool canDeploy(Player& player)
+Territory* TurnPlan::getStrongest() const
 {
-    vector<Order*>& orders = player.getOrders()->getOrdersList();
-    if((int)orders.size() < 3) return true;
-    vector<Order*> lastThreeOrders(orders.end() - 3, orders.end());
-    for(Order* order : lastThreeOrders)
+    return strongest;
+}
+
+// The weakest territories only have to be searched again when they were reinforced, as the others only grew too
+Territory* TurnPlan::getWeakest()
+{
+    if (weakest != nullptr && weakest->armies != weakestArmies)
     {
-        if(order->getType() == Order::Type::Deploy)
+        weakest = findWeakest(player->getTerritories());
+        weakestArmies = weakest->armies;
+    }
+    return weakest;
+}
+
+Territory* TurnPlan::getWeakestEnemy()
+{
+    if (weakestEnemy != nullptr && weakestEnemy->armies != weakestEnemyArmies)
+    {
+        weakestEnemy = findWeakest(player->getAttackableTerritories());
+        weakestEnemyArmies = weakestEnemy->armies;
+    }
+    return weakestEnemy;
+}
+
+const vector<Territory*>& TurnPlan::getFrontier() const
+{
+    return player->getAttackableTerritories();
+}
+
+const vector<Territory*>& TurnPlan::getDefenseOrder() const
+{
+    return defenseOrder;
+}
+
+bool TurnPlan::hasAdvanced(const Territory& territory) const
+{
+    return advancedSources[territory.ID - 1];
+}
+
+size_t TurnPlan::getIssuedCount() const
+{
+    return issuedCount;
+}
+
+// Same rule as canDeploy, for the orders issued this turn, which may not be in the orders list yet
+bool TurnPlan::canDeploy() const
+{
+    return lastDeploy + 3 > issuedCount;
+}
+
+// First territory with the least armies, nullptr if there are none
+Territory* TurnPlan::findWeakest(const vector<Territory*>& territories) const
+{
+    Territory* result = nullptr;
+    for (Territory* territory : territories)
+    {
+        if (result == nullptr || territory->armies < result->armies)
         {
-            return true;
+            result = territory;
         }
     }
-    return false;
+    return result;
 }
 
 // PlayerStrategy
 
-PlayerStrategy::PlayerStrategy()
+PlayerStrategy::PlayerStrategy():
+    passedRound(false)
 {
 
 }
 
 PlayerStrategy::PlayerStrategy(Player& player):
-    player(&player)
+    player(&player),
+    passedRound(false)
 {
 
 }
 
 PlayerStrategy::PlayerStrategy(PlayerStrategy& other):
-    player(other.player)
+    player(other.player),
+    plan(other.plan),
+    passedRound(other.passedRound)
 {
 
 }
@@ -73,6 +262,8 @@ PlayerStrategy::PlayerStrategy(PlayerStrategy& other):
 PlayerStrategy& PlayerStrategy::operator = (const PlayerStrategy& other)
 {
     player = other.player;
+    plan = other.plan;
+    passedRound = other.passedRound;
     return *this;
 }
 
@@ -82,6 +273,43 @@ std::ostream& operator << (std::ostream& out, const PlayerStrategy& source)
     return out;
 }
 
+// Plans the turn from the player's territories as they are before any order is issued
+void PlayerStrategy::planTurn(GameEngine& gameEngine)
+{
+    plan.prepare(*player, gameEngine.getMap());
+}
+
+// An empty order means that the strategy has no more orders, unless it only played a Reinforcement card
+bool PlayerStrategy::isDoneIssuing() const
+{
+    return !passedRound;
+}
+
+// Deploy orders change armies as they are issued, so by default a strategy is asked for its orders in turn with the other players
+bool PlayerStrategy::canIssueOrdersAtOnce() const
+{
+    return false;
+}
+
+// Issues orders until there are no more, as the game engine would by asking for them one by one
+void PlayerStrategy::issueOrders(GameEngine& gameEngine, OrderSink& sink)
+{
+    while (true)
+    {
+        OrderData order = issueOrder(gameEngine);
+        if (order.empty())
+        {
+            // The next orders are only issued if the phase goes on after this round
+            if (!isDoneIssuing())
+            {
+                sink.pass();
+            }
+            return;
+        }
+        sink.add(order);
+    }
+}
+
 
 // HumanPlayerStrategy
 
@@ -123,7 +351,28 @@ std::ostream& operator << (std::ostream& out, const HumanPlayerStrategy& source)
     return out;
 }
 
-Order* HumanPlayerStrategy::issueOrder(GameEngine& gameEngine)
+// An empty order means that the user is done for the turn, so an invalid answer asks again
+OrderData HumanPlayerStrategy::issueOrder(GameEngine& gameEngine)
+{
+    Order* order = promptOrder(gameEngine);
+    while (order == nullptr)
+    {
+        // Also stop once there is no more input to read
+        if (finishedOrders || !std::cin)
+        {
+            finishedOrders = true;
+            return OrderData();
+        }
+        order = promptOrder(gameEngine);
+    }
+
+    OrderData result = order->getData();
+    delete order;
+    return result;
+}
+
+// Asks the human player for an order, until they issue a valid one or stop issuing orders
+Order* HumanPlayerStrategy::promptOrder(GameEngine& gameEngine)
 {
     // Reset "end orders" flag on new turn
     if (gameEngine.getTurnIndex() != lastTurnIdx)
@@ -144,10 +393,10 @@ Order* HumanPlayerStrategy::issueOrder(GameEngine& gameEngine)
     std::cout << "You have " << player->getArmies() << " armies in reserve. You own " << player->getTerritories().size() << " territories.\n";
 
     std::string hand = "Empty";
-    if (player->getCards()->getCards().size() > 0)
+    if (player->getCards()->size() > 0)
     {
         std::ostringstream stream;
-        for (Card* card : player->getCards()->getCards())
+        for (Card* card : *player->getCards())
         {
             stream << card->getType() << " ";
         }
@@ -268,17 +517,8 @@ Order* HumanPlayerStrategy::issueOrder(GameEngine& gameEngine)
             // check if the player has the bomb card. if they do then ask which territory to bomb
             std::cout<<"you chose Bomb\n";
             Hand* playerHand = this->player->getCards();
-            Card* cardInHand = nullptr;
             Bomb* bombTemp;
-            for (Card* card : playerHand->getCards())
-            {
-                Card::Type cardType = card->getType();
-                if (cardType == Card::Type::Bomb)
-                {
-                    cardInHand = card;
-                }
-            }
-            if (cardInHand != nullptr)
+            if (playerHand->has(Card::Type::Bomb))
             {
                 int targetTerritoryId;
                 std::cout<<"Please input the ID of the territory you would like to bomb or input '0' to see a list of territories which can be bombed:\n";
@@ -296,7 +536,7 @@ Order* HumanPlayerStrategy::issueOrder(GameEngine& gameEngine)
                 bombTemp=new Bomb(*this->player,*targetTerritory);
                 if (bombTemp->validate())
                 {
-                    cardInHand->play();
+                    playerHand->take(Card::Type::Bomb)->play(gameEngine.getContext());
                     return bombTemp;
                 }
             }else{
@@ -310,16 +550,7 @@ Order* HumanPlayerStrategy::issueOrder(GameEngine& gameEngine)
             // check if the player has the blockade card. if they do then ask which territory to blockade
             std::cout<<"you chose Blockade\n";
             Hand* playerHand = this->player->getCards();
-            Card* cardInHand = nullptr;
-            for (Card* card : playerHand->getCards())
-            {
-                Card::Type cardType = card->getType();
-                if (cardType == Card::Type::Blockade)
-                {
-                    cardInHand = card;
-                }
-            }
-            if (cardInHand != nullptr)
+            if (playerHand->has(Card::Type::Blockade))
             {
                 int blockadeTerritoryId;
                 std::cout<<"Please input the ID of the territory you would like to blockade or input '0' to see a list of territories which you own:\n";
@@ -335,7 +566,7 @@ Order* HumanPlayerStrategy::issueOrder(GameEngine& gameEngine)
                 }
                 Territory* blockadeTerritory = gameEngine.getMap().getTerritoryByID(blockadeTerritoryId);
 
-                cardInHand->play();
+                playerHand->take(Card::Type::Blockade)->play(gameEngine.getContext());
                 return new Blockade(*this->player,gameEngine.getNeutralPlayer(),*blockadeTerritory);
             }else{
                 std::cout<<"You don't have a Blockade card in your hand.\n";
@@ -349,16 +580,7 @@ Order* HumanPlayerStrategy::issueOrder(GameEngine& gameEngine)
             // and how many armies to airlift
             std::cout<<"you chose Airlift\n";
             Hand* playerHand = this->player->getCards();
-            Card* cardInHand = nullptr;
-            for (Card* card : playerHand->getCards())
-            {
-                Card::Type cardType = card->getType();
-                if (cardType == Card::Type::Airlift)
-                {
-                    cardInHand = card;
-                }
-            }
-            if (cardInHand != nullptr)
+            if (playerHand->has(Card::Type::Airlift))
             {
                 int sourceTerritoryId,targetTerritoryId,armies;
                 std::cout<<"Please input the ID of the territory you would like to Airlift from or input '0' to see a list of territories which you own:\n";
@@ -380,7 +602,7 @@ Order* HumanPlayerStrategy::issueOrder(GameEngine& gameEngine)
                 std::cout<<"How many armies would you like to airlift? ("<<sourceTerritory->armies<<" available)\n";
                 std::cin >> armies;
 
-                cardInHand->play();
+                playerHand->take(Card::Type::Airlift)->play(gameEngine.getContext());
                 return new Airlift(armies,*this->player,*sourceTerritory,*targetTerritory);
             }else{
                 std::cout<<"You don't have a Airlift card in your hand.\n";
@@ -393,17 +615,8 @@ Order* HumanPlayerStrategy::issueOrder(GameEngine& gameEngine)
             // check if the player has the bomb card. if they do then ask which player to negotiate with
             std::cout<<"you chose Negotiate\n";
             Hand* playerHand = this->player->getCards();
-            Card* cardInHand = nullptr;
             Player* targetPlayer;
-            for (Card* card : playerHand->getCards())
-            {
-                Card::Type cardType = card->getType();
-                if (cardType == Card::Type::Diplomacy)
-                {
-                    cardInHand = card;
-                }
-            }
-            if (cardInHand != nullptr)
+            if (playerHand->has(Card::Type::Diplomacy))
             {
                 int targetPlayerID;
                 std::cout<<"Please input the id of the player you would like to negotiate with or input '0' to see a list of players IDs:\n";
@@ -440,7 +653,7 @@ Order* HumanPlayerStrategy::issueOrder(GameEngine& gameEngine)
                         counter++;
                     }
                 }
-                cardInHand->play();
+                playerHand->take(Card::Type::Diplomacy)->play(gameEngine.getContext());
                 return new Negotiate(*this->player,*targetPlayer);
             }else{
                 std::cout<<"You don't have a Diplomacy card in your hand.\n";
@@ -470,7 +683,7 @@ Order* HumanPlayerStrategy::issueOrder(GameEngine& gameEngine)
 // returns a vector of all territories that can be attacked by the player
 vector<Territory*> HumanPlayerStrategy::toAttack(GameEngine& gameEngine)
 {
-    vector<Territory*> tmp=canAttack(*this->player);
+    vector<Territory*> tmp=this->player->getAttackableTerritories();
     return tmp;
 }
 // returns a vector of all territories owned by the player
@@ -513,73 +726,87 @@ std::ostream& operator << (std::ostream& out, const BenevolentPlayerStrategy& so
     return out;
 }
 
-Order* BenevolentPlayerStrategy::issueOrder(GameEngine& gameEngine)
+OrderData BenevolentPlayerStrategy::issueOrder(GameEngine& gameEngine)
 {
-    //list of territories needed to be defended
-    vector<Territory*> territoriesToDefend = toDefend(gameEngine);
+    passedRound = false;
+
+    //list of territories needed to be defended, the weakest first
+    const vector<Territory*>& territoriesToDefend = plan.getDefenseOrder();
 
-    //Deploying the armies to the last territory
+    //Deploying the armies to the weakest territory
     int num_armies_available = this->player->getArmies();
     if(num_armies_available > 0) {
-        return new Deploy(min(num_armies_available, 10), *this->player, *territoriesToDefend.at(0));
+        return plan.issued(OrderData::deploy(min(num_armies_available, 10), *this->player, *territoriesToDefend.at(0)));
     }
     //Player hand
     Hand* main= this->player->getCards();
-    for (Card* card : main->getCards())
+    for (int cardIndex = 0; cardIndex < main->size(); ++cardIndex)
     {
+        Card* card = main->getCard(cardIndex);
         Card::Type cardType = card->getType();
-        Order* result = nullptr;
 
         if (cardType == Card::Type::Reinforcement){
-            card->play();
+            card->play(gameEngine.getContext());
             this->player->setArmies(this->player->getArmies() + 10);
+            // If no other order comes this round, the new armies are deployed in the next one
+            passedRound = true;
+            // The next card took the place of the one played
+            cardIndex--;
         }
         else if (cardType == Card::Type::Airlift) {
-            card->play();
-            return result = new Airlift(territoriesToDefend[0]->armies, *this->player, *territoriesToDefend[territoriesToDefend.size()-1], *territoriesToDefend[0]);
+            card->play(gameEngine.getContext());
+            return plan.issued(OrderData::airlift(territoriesToDefend[0]->armies, *this->player, *territoriesToDefend[territoriesToDefend.size()-1], *territoriesToDefend[0]));
         }
         else if (cardType == Card::Type::Blockade){
-            card->play();
-            return result = new Blockade(*this->player,gameEngine.getNeutralPlayer(),*territoriesToDefend[0]);
+            card->play(gameEngine.getContext());
+            return plan.issued(OrderData::blockade(*this->player,gameEngine.getNeutralPlayer(),*territoriesToDefend[0]));
         }
         else if (cardType == Card::Type::Diplomacy){
            for (Player* otherPlayer : gameEngine.getAlivePlayers())
            {
                if (otherPlayer != player)
                {
-                   card->play();
-                   return result = new Negotiate(*this->player, *otherPlayer);
+                   card->play(gameEngine.getContext());
+                   return plan.issued(OrderData::negotiate(*this->player, *otherPlayer));
                }
            }
         }
-
-        if (result != nullptr)
-        {
-            return result;
-        }
     }
 
     //Advance the armies.
-    vector<Order*> orders = this->player->getOrders()->getOrdersList();
-    for(Territory* friendly_territory : toDefend(gameEngine))
+    // Territories before the plan's cursor were already advanced from, or can't be: that doesn't change during the turn
+    const Map& map = gameEngine.getMap();
+    for(; plan.defenseCursor < territoriesToDefend.size(); ++plan.defenseCursor)
     {
-         bool alreadyAdvancedFromThisTerritory = find_if(orders.begin(), orders.end(), [&](Order* order) {
-            return order->getType() == Order::Type::Advance && dynamic_cast<Advance*>(order)->getSourceTerritory() == friendly_territory;
-        }) != orders.end();
+        Territory* friendly_territory = territoriesToDefend[plan.defenseCursor];
         // Don't even consider advancing from this territory if you've already advanced from it this turn
         // We also can't advance from it onto a neighbouring friendly territory if it has no armies on it in the first place
-        if(alreadyAdvancedFromThisTerritory || friendly_territory->armies == 0) continue;
+        if(plan.hasAdvanced(*friendly_territory) || friendly_territory->armies == 0) continue;
         // If you haven't, see if it has neighbouring friendly territories which you could advance to
-        for(Territory* neighbouring_territory : friendly_territory->neighbors)
+        for(uint32_t neighbourIndex : map.getNeighborIndices(friendly_territory->ID - 1))
         {
+            Territory* neighbouring_territory = map.territories[neighbourIndex];
             if(neighbouring_territory->player == this->player)
             {
-                return new Advance(5, *this->player, *friendly_territory, *neighbouring_territory, false);
+                return plan.issued(OrderData::advance(5, *this->player, *friendly_territory, *neighbouring_territory, false));
             }
         }
     }
 
-    return nullptr;
+    return OrderData();
+}
+
+// Deploys and advances only depend on the player's own territories, which the other players don't change while issuing orders
+bool BenevolentPlayerStrategy::canIssueOrdersAtOnce() const
+{
+    return true;
+}
+
+// Plans the deployments and advances, starting from the weakest territories
+void BenevolentPlayerStrategy::planTurn(GameEngine& gameEngine)
+{
+    PlayerStrategy::planTurn(gameEngine);
+    plan.prepareDefense();
 }
 
 //Benevolent player is not attacking any player. So return an empty vector of territories
@@ -632,117 +859,108 @@ std::ostream& operator << (std::ostream& out, const AggressivePlayerStrategy& so
     return out;
 }
 
-Order* AggressivePlayerStrategy::issueOrder(GameEngine& gameEngine)
+OrderData AggressivePlayerStrategy::issueOrder(GameEngine& gameEngine)
 {
+    passedRound = false;
 
-    // ----- Friendly territories ----- //
-    vector<Territory*> ownedTerritories = this->player->getTerritories();
-
-    // --- Strongest --- //
-    // First we find the iterator of Territory with the most armies
-    // We're guaranteed that this won't be owned.end() because if the player had no territories, then the player would have already lost
-    vector<Territory*>::iterator it_friendly_max = max_element(ownedTerritories.begin(), ownedTerritories.end(), [&](Territory* a, Territory* b) {
-        return a->armies < b->armies;
-    });
-    Territory* strongest_friendly_territory = *it_friendly_max;
-
-    // --- Weakest --- //
-    vector<Territory*>::iterator it_friendly_min = max_element(ownedTerritories.begin(), ownedTerritories.end(), [&](Territory* a, Territory* b) {
-        return b->armies - a->armies > 0;
-    });
-    Territory* weakest_friendly_territory = *it_friendly_min;
-
-    // --- Weakest enemy territory --- //
-    vector<Territory*> enemyTerritories = toAttack(gameEngine); 
-    vector<Territory*>::iterator it_enemy_min = max_element(enemyTerritories.begin(), enemyTerritories.end(), [&](Territory* a, Territory* b) {
-        return b->armies - a->armies > 0;
-    });
-    Territory* weakest_enemy_territory = *it_enemy_min;
+    // The strongest territory is known from the turn plan
+    // We're guaranteed that there is one because if the player had no territories, then the player would have already lost
+    Territory* strongest_friendly_territory = plan.getStrongest();
 
-    
     // First deploy
     int num_armies_available = this->player->getArmies();
-    if(num_armies_available > 0 && canDeploy(*this->player)) {
+    if(num_armies_available > 0 && plan.canDeploy()) {
         // As an aggressive player, we put all our armies on our strongest territory (on our territory which contains the most units)
-        return new Deploy(num_armies_available, *this->player, *strongest_friendly_territory);
+        return plan.issued(OrderData::deploy(num_armies_available, *this->player, *strongest_friendly_territory));
     }
 
     // Try to play a card
     // The aggressive player only uses the Airlift, Reinforcement and Bomb cards
     Hand* playerHand = this->player->getCards();
-    for (Card* card : playerHand->getCards())
+    for (Card* card : *playerHand)
     {
         Card::Type cardType = card->getType();
 
-        Order* result = nullptr;
+        OrderData result;
 
         if (cardType == Card::Type::Airlift)
         {
             // Move our weakest territory's armies to our strongest territory's armies as long as they're not the same
+            const vector<Territory*>& ownedTerritories = this->player->getTerritories();
+            Territory* weakest_friendly_territory = *max_element(ownedTerritories.begin(), ownedTerritories.end(), [&](Territory* a, Territory* b) {
+                return b->armies - a->armies > 0;
+            });
             if(weakest_friendly_territory != strongest_friendly_territory)
             {
-                result = new Airlift(weakest_friendly_territory->armies, *this->player, *weakest_friendly_territory, *strongest_friendly_territory);
-                card->play();
+                result = OrderData::airlift(weakest_friendly_territory->armies, *this->player, *weakest_friendly_territory, *strongest_friendly_territory);
+                card->play(gameEngine.getContext());
             }
         }
         else if (cardType == Card::Type::Bomb)
         {
             // Don't bomb territories that have no armies on them
-            if(weakest_enemy_territory->armies != 0)
+            const vector<Territory*>& enemyTerritories = plan.getFrontier();
+            Territory* weakest_enemy_territory = enemyTerritories.empty() ? nullptr : *max_element(enemyTerritories.begin(), enemyTerritories.end(), [&](Territory* a, Territory* b) {
+                return b->armies - a->armies > 0;
+            });
+            if(weakest_enemy_territory != nullptr && weakest_enemy_territory->armies != 0)
             {
-                result = new Bomb(*this->player, *weakest_enemy_territory);
-                card->play();
+                result = OrderData::bomb(*this->player, *weakest_enemy_territory);
+                card->play(gameEngine.getContext());
             }
         }
         else if (cardType == Card::Type::Reinforcement)
         {
             this->player->setArmies(this->player->getArmies() + 5);
-            card->play();
-            return nullptr;
+            card->play(gameEngine.getContext());
+            // The turn goes on, the new armies can be deployed in the next round
+            passedRound = true;
+            return OrderData();
         }
 
-        if (result != nullptr)
+        if (!result.empty())
         {
-            return result;
+            return plan.issued(result);
         }
     }
 
-    vector<Order*> orders = this->player->getOrders()->getOrdersList();
+    const Map& map = gameEngine.getMap();
     // Advance with your strongest army onto enemy neighbours (attacking them)
     // Only advance if you haven't already queued an advance with from this territory
-    bool alreadyAdvancedFromStrongestTerritory = find_if(orders.begin(), orders.end(), [&](Order* order) {
-        return order->getType() == Order::Type::Advance && dynamic_cast<Advance*>(order)->getSourceTerritory() == strongest_friendly_territory;
-    }) != orders.end();
-    if(!alreadyAdvancedFromStrongestTerritory) {
-        for(Territory* neighbouring_territory : strongest_friendly_territory->neighbors)
+    if(!plan.hasAdvanced(*strongest_friendly_territory)) {
+        for(uint32_t neighbourIndex : map.getNeighborIndices(strongest_friendly_territory->ID - 1))
         {
+            Territory* neighbouring_territory = map.territories[neighbourIndex];
             Player* neighbouring_territory_player = neighbouring_territory->player;
             if(neighbouring_territory_player != this->player && strongest_friendly_territory->armies > 0) {
-                return new Advance(strongest_friendly_territory->armies, *this->player, *strongest_friendly_territory, *neighbouring_territory);
+                return plan.issued(OrderData::advance(strongest_friendly_territory->armies, *this->player, *strongest_friendly_territory, *neighbouring_territory));
             }
         }
     }
-    
+
     // If there are no enemy territories near your strongest territory, randomly attack with another of your territories
     // As long as this territory hasn't already issued an advance order this turn
-    for(Territory* neighbour : enemyTerritories[0]->neighbors)
+    const vector<Territory*>& enemyTerritories = plan.getFrontier();
+    if(enemyTerritories.empty()) {
+        // We didn't manage to find any territories that we can attack, we have already won
+        return OrderData();
+    }
+    for(uint32_t neighbourIndex : map.getNeighborIndices(enemyTerritories[0]->ID - 1))
     {
+        Territory* neighbour = map.territories[neighbourIndex];
         bool neighbour_is_owned = neighbour->player == this->player;
-        bool alreadyAdvancedFromNeighbour = find_if(orders.begin(), orders.end(), [&](Order* order) {
-            return order->getType() == Order::Type::Advance && dynamic_cast<Advance*>(order)->getSourceTerritory() == neighbour;
-        }) != orders.end();
-        if(neighbour_is_owned && neighbour->armies > 0 && !alreadyAdvancedFromNeighbour) {
-            return new Advance(neighbour->armies, *this->player, *neighbour, *enemyTerritories[0]);
+        if(neighbour_is_owned && neighbour->armies > 0 && !plan.hasAdvanced(*neighbour)) {
+            return plan.issued(OrderData::advance(neighbour->armies, *this->player, *neighbour, *enemyTerritories[0]));
         }
     }
-    
-    // We shouldn't ever get here. If we didn't manage to find any territories that we can attack, then we have already won
-    return nullptr;
+
+    // Every territory that could attack already did
+    return OrderData();
 }
 
 vector<Territory*> AggressivePlayerStrategy::toAttack(GameEngine& gameEngine)
 {
-    vector<Territory*> tmp = canAttack(*this->player);
+    vector<Territory*> tmp = this->player->getAttackableTerritories();
     return tmp;
 }
 
@@ -786,32 +1004,38 @@ std::ostream& operator << (std::ostream& out, const CheaterPlayerStrategy& sourc
     return out;
 }
 
-Order* CheaterPlayerStrategy::issueOrder(GameEngine& gameEngine)
+OrderData CheaterPlayerStrategy::issueOrder(GameEngine& gameEngine)
 {
-    // Prepare list of adjacent territories the player will attack and conquer this turn
-    vector<Territory*> territoriesToAttack = toAttack(gameEngine);
+    // Adjacent territories the player will attack and conquer this turn
+    const vector<Territory*>& territoriesToAttack = plan.getFrontier();
 
     // Since cheater player ignores armies when conquering we will just stack their armies on it first owned territory
     int num_armies_available = this->player->getArmies();
     if(num_armies_available > 0) {
-        return new Deploy(num_armies_available, *this->player, *this->player->getTerritories().at(0));
+        return plan.issued(OrderData::deploy(num_armies_available, *this->player, *this->player->getTerritories().at(0)));
     }
 
     // Get current amount of orders, to determine which territory we will attack assuming first order will always be deploy
-    size_t pos = this->player->getOrders()->getOrdersList().size();
+    size_t pos = plan.getIssuedCount();
     if (pos <= territoriesToAttack.size()) {
-        return new Advance(99, *this->player, *this->player->getTerritories().at(0), *territoriesToAttack.at(pos - 1),true);
+        return plan.issued(OrderData::advance(99, *this->player, *this->player->getTerritories().at(0), *territoriesToAttack.at(pos - 1),true));
         // All advance orders for all adjacent enemy territories are done so we stop issuing orders
     } else {
-        return nullptr;
+        return OrderData();
     }
 
 }
 
+// The frontier is planned when the turn starts, and the armies of the territories around it don't matter
+bool CheaterPlayerStrategy::canIssueOrdersAtOnce() const
+{
+    return true;
+}
+
 // Returning all adjacent enemy territories the player can attack
 vector<Territory*> CheaterPlayerStrategy::toAttack(GameEngine& gameEngine)
 {
-    vector<Territory*> tmp = canAttack(*this->player);
+    vector<Territory*> tmp = this->player->getAttackableTerritories();
     return tmp;
 }
 
@@ -886,9 +1110,9 @@ std::ostream &operator<<(ostream &out, const NeutralPlayerStrategy &source) {
 
 //issueOrder()
 //Does nothing. Issue order can't create any orders
-Order *NeutralPlayerStrategy::issueOrder(GameEngine &gameEngine)
+OrderData NeutralPlayerStrategy::issueOrder(GameEngine &gameEngine)
 {
-    return nullptr;
+    return OrderData();
 }
 
 //toAttack()
@@ -903,6 +1127,27 @@ vector<Territory *> NeutralPlayerStrategy::toDefend(GameEngine &gameEngine)
     return vector<Territory*>();
 }
 
+//planTurn()
+//Nothing to prepare since no orders are issued
+void NeutralPlayerStrategy::planTurn(GameEngine &gameEngine)
+{
+
+}
+
+//canIssueOrdersAtOnce()
+//Nothing to wait for since no orders are issued
+bool NeutralPlayerStrategy::canIssueOrdersAtOnce() const
+{
+    return true;
+}
+
+//issueOrders()
+//Does nothing either
+void NeutralPlayerStrategy::issueOrders(GameEngine &gameEngine, OrderSink &sink)
+{
+
+}
+
 void NeutralPlayerStrategy::becomeAggressive()
 {
     if (!becameAggressive)
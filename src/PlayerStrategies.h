@@ -8,9 +8,58 @@ using std::vector;
 using std::string;
 
 class Order;
+struct OrderData;
+class OrderSink;
 class Player;
 
 
+//========== TurnPlan Class ==========//
+
+// What a computer strategy knows about its player's position during the issue orders phase: computed once when
+// the turn starts, then kept up to date as the strategy issues orders instead of being recomputed for each order.
+// During that phase territories don't change hands and armies only grow (Deploy orders place them right away).
+class TurnPlan
+{
+public:
+
+    TurnPlan(); // Default Constructor
+    TurnPlan(const TurnPlan& other); // Copy Constructor
+    ~TurnPlan(); // Destructor
+    TurnPlan& operator = (const TurnPlan& other); // Assignment operator overloading
+    friend std::ostream& operator << (std::ostream& out, const TurnPlan& source); // Input stream operator
+
+    void prepare(Player& player, const Map& map); // Computes the plan of a player for the turn that starts
+    void prepareDefense(); // Also orders the player's territories from the weakest to the strongest, for defensive strategies
+    OrderData issued(const OrderData& order); // Updates the plan with an order the player issues, and returns that order
+
+    Territory* getStrongest() const; // Owned territory with the most armies (the first one in the player's territories on ties)
+    Territory* getWeakest(); // Owned territory with the least armies (the first one on ties)
+    Territory* getWeakestEnemy(); // Enemy neighbor with the least armies (the first one on ties), nullptr if there are none
+    const vector<Territory*>& getFrontier() const; // Enemy neighbors of the player's territories
+    const vector<Territory*>& getDefenseOrder() const; // Owned territories by armies, the weakest first (see prepareDefense)
+    bool hasAdvanced(const Territory& territory) const; // Checks if an Advance order from a territory was issued this turn
+    size_t getIssuedCount() const; // Number of orders issued this turn
+    bool canDeploy() const; // Checks if one of the last three orders issued this turn was a Deploy order (or if there are less than three)
+
+    size_t defenseCursor; // Territories before it in the defense order can't be advanced from anymore this turn
+
+private:
+
+    Player* player;
+    Territory* strongest;
+    Territory* weakest;
+    Territory* weakestEnemy;
+    int weakestArmies; // Armies of the weakest territories when they were found, to notice when they grow
+    int weakestEnemyArmies;
+    vector<Territory*> defenseOrder;
+    vector<bool> advancedSources; // One bit per territory (index = ID - 1)
+    size_t issuedCount;
+    size_t lastDeploy; // Number of orders issued this turn when the last Deploy order was, 0 if there was none
+
+    Territory* findWeakest(const vector<Territory*>& territories) const; // First territory with the least armies
+};
+
+
 //========== PlayerStrategy (Abstract) Class ==========//
 
 class PlayerStrategy
@@ -24,11 +73,20 @@ public:
     PlayerStrategy& operator = (const PlayerStrategy& other); // Assignment operator overloading
     friend std::ostream& operator << (std::ostream& out, const PlayerStrategy& source); // Input stream operator
 
-    virtual Order* issueOrder(GameEngine& gameEngine) = 0;  // Pure virtual method issueOrder()
+    virtual OrderData issueOrder(GameEngine& gameEngine) = 0;  // Pure virtual method issueOrder(), returns an empty order when there are no more orders to issue
     virtual vector<Territory*> toAttack(GameEngine& gameEngine) = 0; // Pure virtual method toAttack()
     virtual vector<Territory*> toDefend(GameEngine& gameEngine) = 0; // Pure virtual method toDefend()
+    virtual void planTurn(GameEngine& gameEngine); // Prepares the turn plan, called when the issue orders phase starts
+    virtual bool canIssueOrdersAtOnce() const; // Whether the strategy's orders don't depend on what the other players issue before them this turn
+    virtual void issueOrders(GameEngine& gameEngine, OrderSink& sink); // Issues all the orders of the turn at once
+    bool isDoneIssuing() const; // After issueOrder returned an empty order: false if the strategy only passed its turn in this round
 
     Player* player;
+
+protected:
+
+    TurnPlan plan;
+    bool passedRound; // The last call to issueOrder played a Reinforcement card, whose armies are deployed in the next round
 };
 
 
@@ -45,12 +103,14 @@ public:
     HumanPlayerStrategy& operator = (const HumanPlayerStrategy& other); // Assignment operator overloading
     friend std::ostream& operator << (std::ostream& out, const HumanPlayerStrategy& source); // Input stream operator
 
-    Order* issueOrder(GameEngine& gameEngine) override; // Overriding virtual function issueOrder() from base class PlayerStrategy
+    OrderData issueOrder(GameEngine& gameEngine) override; // Overriding virtual function issueOrder() from base class PlayerStrategy
     vector<Territory*> toAttack(GameEngine& gameEngine) override;   // Overriding virtual function toAttack() from base class PlayerStrategy
     vector<Territory*> toDefend(GameEngine& gameEngine) override;   // Overriding virtual function toDefend() from base class PlayerStrategy
 
 private:
 
+    Order* promptOrder(GameEngine& gameEngine);    // Asks the user for an order (nullptr if they stop issuing orders)
+
     int lastTurnIdx;
     bool finishedOrders;
 };
@@ -70,9 +130,11 @@ public:
     BenevolentPlayerStrategy& operator = (const BenevolentPlayerStrategy& other); // Assignment operator overloading
     friend std::ostream& operator << (std::ostream& out, const BenevolentPlayerStrategy& source); // Input stream operator
 
-    Order* issueOrder(GameEngine& gameEngine) override; // Overriding virtual function issueOrder() from base class PlayerStrategy
+    OrderData issueOrder(GameEngine& gameEngine) override; // Overriding virtual function issueOrder() from base class PlayerStrategy
     vector<Territory*> toAttack(GameEngine& gameEngine) override;   // Overriding virtual function toAttack() from base class PlayerStrategy
     vector<Territory*> toDefend(GameEngine& gameEngine) override;   // Overriding virtual function toDefend() from base class PlayerStrategy
+    bool canIssueOrdersAtOnce() const override; // Only looks at its own territories
+    void planTurn(GameEngine& gameEngine) override; // Also plans which territories to defend first
 };
 
 
@@ -90,7 +152,7 @@ public:
     AggressivePlayerStrategy& operator = (const AggressivePlayerStrategy& other); // Assignment operator overloading
     friend std::ostream& operator << (std::ostream& out, const AggressivePlayerStrategy& source); // Input stream operator
 
-    Order* issueOrder(GameEngine& gameEngine) override; // Overriding virtual function issueOrder() from base class PlayerStrategy
+    OrderData issueOrder(GameEngine& gameEngine) override; // Overriding virtual function issueOrder() from base class PlayerStrategy
     vector<Territory*> toAttack(GameEngine& gameEngine) override;   // Overriding virtual function toAttack() from base class PlayerStrategy
     vector<Territory*> toDefend(GameEngine& gameEngine) override;   // Overriding virtual function toDefend() from base class PlayerStrategy
 };
@@ -110,9 +172,10 @@ public:
     CheaterPlayerStrategy& operator = (const CheaterPlayerStrategy& other); // Assignment operator overloading
     friend std::ostream& operator << (std::ostream& out, const CheaterPlayerStrategy& source); // Input stream operator
 
-    Order* issueOrder(GameEngine& gameEngine) override; // Overriding virtual function issueOrder() from base class PlayerStrategy
+    OrderData issueOrder(GameEngine& gameEngine) override; // Overriding virtual function issueOrder() from base class PlayerStrategy
     vector<Territory*> toAttack(GameEngine& gameEngine) override;   // Overriding virtual function toAttack() from base class PlayerStrategy
     vector<Territory*> toDefend(GameEngine& gameEngine) override;   // Overriding virtual function toDefend() from base class PlayerStrategy
+    bool canIssueOrdersAtOnce() const override; // Conquers its neighbours whatever their armies
 };
 
 
@@ -131,9 +194,12 @@ public:
     NeutralPlayerStrategy& operator = (const NeutralPlayerStrategy& other); // Assignment operator overloading
     friend std::ostream& operator << (std::ostream& out, const NeutralPlayerStrategy& source); // Input stream operator
 
-    Order* issueOrder(GameEngine& gameEngine) override; // Overriding virtual function issueOrder() from base class PlayerStrategy
+    OrderData issueOrder(GameEngine& gameEngine) override; // Overriding virtual function issueOrder() from base class PlayerStrategy
     vector<Territory*> toAttack(GameEngine& gameEngine) override;   // Overriding virtual function toAttack() from base class PlayerStrategy
     vector<Territory*> toDefend(GameEngine& gameEngine) override;   // Overriding virtual function toDefend() from base class PlayerStrategy
+    void planTurn(GameEngine& gameEngine) override; // Nothing to plan, a neutral player never issues orders
+    bool canIssueOrdersAtOnce() const override; // Never issues orders
+    void issueOrders(GameEngine& gameEngine, OrderSink& sink) override; // Issues nothing, without asking issueOrder
 
     void becomeAggressive();
 
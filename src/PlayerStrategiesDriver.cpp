@@ -22,17 +22,14 @@ void testHuman(GameEngine& gameEngine);
 
 int main()
 {
-    // Randomize seed
-    srand(static_cast<unsigned int>(time(NULL)));
-
     // Log to file
     LogObserver logObserver;
 
     // Game engine
     GameEngine gameEngine;
 
-    // Attach our observer
-    gameEngine.attach(logObserver);
+    // Log the events of the game engine
+    logObserver.subscribe();
 
     // Launch tests
     logObserver.appendLine("TESTING CHEATER");
@@ -0,0 +1,268 @@
+#include "Random.h"
+
+#include <cmath>
+
+// Rotates the bits of x to the left by k
+static std::uint64_t rotateLeft(std::uint64_t x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+// Produces well-mixed values from a sequential counter, used to expand a seed into a full state
+static std::uint64_t splitMix64(std::uint64_t& x)
+{
+    std::uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+// log(k!), exact for small k and using the Stirling series otherwise
+static double logFactorial(int k)
+{
+    static const double smallValues[10] =
+    {
+        0.0,
+        0.0,
+        0.69314718055994531,
+        1.79175946922805500,
+        3.17805383034794562,
+        4.78749174278204599,
+        6.57925121201010100,
+        8.52516136106541430,
+        10.60460290274525023,
+        12.80182748008146961
+    };
+
+    if (k < 10)
+    {
+        return smallValues[k];
+    }
+
+    // log(k!) = lgamma(x) with x = k + 1
+    const double x = k + 1.0;
+    const double x2 = x * x;
+    return (x - 0.5) * std::log(x) - x + 0.91893853320467274 + (1.0 / 12.0 - (1.0 / 360.0 - 1.0 / (1260.0 * x2)) / x2) / x;
+}
+
+/* --- Random --- */
+
+Random::Random()
+{
+    seed(0);
+}
+
+Random::Random(std::uint64_t seed)
+{
+    this->seed(seed);
+}
+
+Random::Random(const Random& other)
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        state[i] = other.state[i];
+    }
+}
+
+Random::~Random()
+{
+
+}
+
+Random& Random::operator = (const Random& other)
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        state[i] = other.state[i];
+    }
+    return *this;
+}
+
+std::ostream& operator << (std::ostream& out, const Random& source)
+{
+    out << "Random[" << source.state[0] << " " << source.state[1] << " " << source.state[2] << " " << source.state[3] << "]";
+    return out;
+}
+
+Random::result_type Random::operator () ()
+{
+    const std::uint64_t result = rotateLeft(state[1] * 5, 7) * 9;
+    const std::uint64_t t = state[1] << 17;
+
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+
+    state[2] ^= t;
+
+    state[3] = rotateLeft(state[3], 45);
+
+    return result;
+}
+
+void Random::seed(std::uint64_t seed)
+{
+    // SplitMix64 never produces an all-zero state
+    for (int i = 0; i < 4; ++i)
+    {
+        state[i] = splitMix64(seed);
+    }
+}
+
+void Random::jump()
+{
+    static const std::uint64_t jumpPolynomial[4] =
+    {
+        0x180ec6d33cfd0abaULL,
+        0xd5a61266f0c9392cULL,
+        0xa9582618e03fc9aaULL,
+        0x39abdc4529b1661cULL
+    };
+
+    std::uint64_t jumped[4] = { 0, 0, 0, 0 };
+    for (int i = 0; i < 4; ++i)
+    {
+        for (int bit = 0; bit < 64; ++bit)
+        {
+            if (jumpPolynomial[i] & (1ULL << bit))
+            {
+                for (int j = 0; j < 4; ++j)
+                {
+                    jumped[j] ^= state[j];
+                }
+            }
+            (*this)();
+        }
+    }
+
+    for (int i = 0; i < 4; ++i)
+    {
+        state[i] = jumped[i];
+    }
+}
+
+int Random::nextInt(int bound)
+{
+    // Lemire's multiply-shift, with rejection of the few values that would bias the result
+    const std::uint32_t range = static_cast<std::uint32_t>(bound);
+    std::uint64_t product = ((*this)() >> 32) * range;
+    std::uint32_t low = static_cast<std::uint32_t>(product);
+
+    if (low < range)
+    {
+        const std::uint32_t threshold = (0u - range) % range;
+        while (low < threshold)
+        {
+            product = ((*this)() >> 32) * range;
+            low = static_cast<std::uint32_t>(product);
+        }
+    }
+
+    return static_cast<int>(product >> 32);
+}
+
+float Random::nextFloat()
+{
+    // Top 24 bits fill the float mantissa exactly
+    return static_cast<float>((*this)() >> 40) * (1.0f / 16777216.0f);
+}
+
+double Random::nextDouble()
+{
+    // Top 53 bits fill the double mantissa exactly
+    return static_cast<double>((*this)() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+int Random::nextBinomial(int trials, double probability)
+{
+    if (trials <= 0 || probability <= 0.0)
+    {
+        return 0;
+    }
+    if (probability >= 1.0)
+    {
+        return trials;
+    }
+
+    // Both algorithms below expect probability <= 0.5, count failures instead of successes otherwise
+    if (probability > 0.5)
+    {
+        return trials - nextBinomial(trials, 1.0 - probability);
+    }
+
+    const double n = trials;
+    const double p = probability;
+    const double q = 1.0 - p;
+
+    if (n * p < 10.0)
+    {
+        // Inversion: walk the cumulative distribution until it exceeds a single uniform draw
+        const double s = p / q;
+        const double a = (n + 1.0) * s;
+
+        while (true)
+        {
+            double r = std::pow(q, n);
+            double u = nextDouble();
+            int successes = 0;
+
+            while (u > r)
+            {
+                u -= r;
+                successes++;
+                if (successes > trials)
+                {
+                    // Rounding error left some probability mass unaccounted for, draw again
+                    break;
+                }
+                r *= a / successes - s;
+            }
+
+            if (successes <= trials)
+            {
+                return successes;
+            }
+        }
+    }
+
+    // Transformed rejection with squeeze (Hormann, "The generation of binomial random variates", 1993)
+    const double spq = std::sqrt(n * p * q);
+    const double b = 1.15 + 2.53 * spq;
+    const double a = -0.0873 + 0.0248 * b + 0.01 * p;
+    const double c = n * p + 0.5;
+    const double vr = 0.92 - 4.2 / b;
+    const double alpha = (2.83 + 5.1 / b) * spq;
+    const double lpq = std::log(p / q);
+    const int mode = static_cast<int>(std::floor((n + 1.0) * p));
+    const double h = logFactorial(mode) + logFactorial(trials - mode);
+
+    while (true)
+    {
+        const double u = nextDouble() - 0.5;
+        double v = nextDouble();
+        const double us = 0.5 - std::fabs(u);
+        const double k = std::floor((2.0 * a / us + b) * u + c);
+
+        if (k < 0.0 || k > n)
+        {
+            continue;
+        }
+
+        const int successes = static_cast<int>(k);
+
+        // Squeeze: quick acceptance in the center of the distribution
+        if (us >= 0.07 && v <= vr)
+        {
+            return successes;
+        }
+
+        // Exact acceptance test against the binomial probability of k
+        v = std::log(v * alpha / (a / (us * us) + b));
+        if (v <= h - logFactorial(successes) - logFactorial(trials - successes) + (successes - mode) * lpq)
+        {
+            return successes;
+        }
+    }
+}
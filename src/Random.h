@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+// Small and fast pseudo-random number generator (xoshiro256**), owned by each game.
+// Its output only depends on its seed, so games can be replayed bit-for-bit on any platform.
+// Meets the UniformRandomBitGenerator requirements, so it can be used with the standard algorithms.
+class Random
+{
+public:
+
+    using result_type = std::uint64_t;
+
+    // Default constructor (fixed seed)
+    Random();
+    // Parametrized constructor
+    explicit Random(std::uint64_t seed);
+    // Copy constructor
+    Random(const Random& other);
+    // Destructor
+    ~Random();
+
+    // Assignment operator
+    Random& operator = (const Random& other);
+    // Stream output operator
+    friend std::ostream& operator << (std::ostream& out, const Random& source);
+
+    // Smallest and largest values returned by operator ()
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+
+    // Returns the next 64 random bits
+    result_type operator () ();
+
+    // Resets the state from a 64-bit seed
+    void seed(std::uint64_t seed);
+
+    // Advances the state by 2^128 steps. Calling it n times on generators with the same seed
+    // gives n non-overlapping streams.
+    void jump();
+
+    // Returns a uniformly distributed integer in [0, bound). Bound must be positive.
+    int nextInt(int bound);
+
+    // Returns a uniformly distributed float in [0, 1)
+    float nextFloat();
+
+    // Returns a uniformly distributed double in [0, 1)
+    double nextDouble();
+
+    // Returns the number of successes out of a number of independent trials, each succeeding with the given probability.
+    // Same distribution as counting nextDouble() < probability over every trial, but in O(1) expected time for large trials.
+    int nextBinomial(int trials, double probability);
+
+    // Shuffles the values in a random order (Fisher-Yates)
+    template <typename T>
+    void shuffle(std::vector<T>& values)
+    {
+        for (size_t i = values.size(); i > 1; --i)
+        {
+            size_t j = static_cast<size_t>(nextInt(static_cast<int>(i)));
+            std::swap(values[i - 1], values[j]);
+        }
+    }
+
+private:
+
+    // Generator state, must never be all zeros
+    std::uint64_t state[4];
+};
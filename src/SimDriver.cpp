@@ -0,0 +1,87 @@
+#include "CommandProcessing.h"
+#include "GameEngine.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// Prints how to use the program
+static void printUsage(const char* program)
+{
+    std::cerr << "Usage: " << program << " [-R <repetitions>] -M <listofmapfiles> -P <listofplayerstrategies> -G <numberofgames> -D <maxnumberofturns> [-T <numberofthreads>] [-S <seed>]" << std::endl;
+}
+
+// Plays tournaments without any logging, and reports how fast games are simulated.
+// Built with WARZONE_HEADLESS, so that the engine publishes no events at all.
+int main(int argc, char* argv[])
+{
+    // Times the tournament is played, each with the next seed
+    long repetitions = 1;
+
+    // The remaining arguments are those of the tournament command
+    std::ostringstream arguments;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "-R") == 0 && i + 1 < argc)
+        {
+            repetitions = std::strtol(argv[++i], nullptr, 10);
+        }
+        else
+        {
+            arguments << argv[i] << " ";
+        }
+    }
+
+    TournamentCommandData tournament;
+    std::istringstream argumentStream(arguments.str());
+    if (repetitions < 1 || !tournament.parseStream(argumentStream))
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    GameEngine gameEngine;
+    std::uint64_t games = 0;
+    std::uint64_t turns = 0;
+    std::string results;
+
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    for (long repetition = 0; repetition < repetitions; ++repetition)
+    {
+        Command command(Command::Type::Tournament);
+        TournamentCommandData* data = new TournamentCommandData(tournament);
+        if (data->hasSeed)
+        {
+            data->seed += repetition;
+        }
+        command.data = data;
+
+        if (!gameEngine.executeCommand(command))
+        {
+            std::cerr << command << std::endl;
+            return 1;
+        }
+
+        games += data->games * data->maps.size();
+        turns += data->turnsPlayed;
+
+        std::ostringstream stream;
+        stream << command;
+        results = stream.str();
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - startTime;
+    double seconds = elapsed.count();
+
+    // Results of the last tournament, then the throughput of all of them
+    std::cout << results << std::endl;
+    std::cout << std::endl;
+    std::cout << "Games: " << games << ", turns: " << turns << ", seconds: " << seconds << std::endl;
+    std::cout << "Games per second: " << games / seconds << ", turns per second: " << turns / seconds << std::endl;
+
+    return 0;
+}
@@ -1,4 +1,5 @@
 #include "CommandProcessing.h"
+#include "EventLog.h"
 #include "GameEngine.h"
 #include "LoggingObserver.h"
 #include "Map.h"
@@ -6,15 +7,27 @@
 #include "Player.h"
 #include "PlayerStrategies.h"
 
+#include <cstring>
 #include <iostream>
 #include <sstream>
 #include <string>
 #include <vector>
 
-int main()
+int main(int argc, char* argv[])
 {
-    // Log to file
-    LogObserver logObserver;
+    // Log to file, as text by default, or as a binary event log with --event-log <file>
+    LogObserver* logObserver = nullptr;
+    for (int i = 1; i + 1 < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--event-log") == 0)
+        {
+            logObserver = new EventLogObserver(argv[i + 1]);
+        }
+    }
+    if (logObserver == nullptr)
+    {
+        logObserver = new LogObserver();
+    }
 
     // Game engine
     GameEngine gameEngine;
@@ -22,9 +35,8 @@ int main()
     // Create console input command processor
     CommandProcessor commandProcessor(gameEngine);
 
-    // Attach our observer
-    gameEngine.attach(logObserver);
-    commandProcessor.attach(logObserver);
+    // Log the events of the game engine and command processor
+    logObserver->subscribe();
 
     // Keep reading commands from input
     while (true)